@@ -0,0 +1,195 @@
+/**
+ *    Filename: bench.cpp
+ * Description: Measures a main screen refresh with the old snprintf based
+ *              formatting and with the format module that replaced it.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#include <msp430g2553.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "hardware.h"
+#include "lcd.h"
+#include "format.h"
+
+// Number of refreshes timed, going through a bunch of different values.
+#define REFRESHES 200000
+
+// Something to keep the compiler from throwing the formatting away.
+volatile char sink;
+
+// The v1.0 buffers were only just big enough, and counted on snprintf cutting
+// things short.
+#pragma GCC diagnostic ignored "-Wformat-truncation"
+
+/**
+ * A main screen refresh.
+ *
+ * @param buf Buffer for the lines.
+ * @param power Heater power in tenths of a W.
+ * @param vin Input voltage in tenths of a V.
+ * @param actual Actual temperature.
+ * @param set Set temperature.
+ * @param print Send the lines to the display?
+ */
+typedef void (*Refresh)(char *buf, const int power, const int vin,
+						const int actual, const int set, const bool print);
+
+/**
+ * The main screen lines as v1.0 formatted them, with snprintf and the float
+ * slicing of the info panel done as integers.
+ */
+void refresh_snprintf(char *buf, const int power, const int vin,
+					  const int actual, const int set, const bool print) {
+	char v_int_str[3];
+	char p_int_str[3];
+
+	// Info panel, padding the integer parts by hand.
+	if (snprintf(v_int_str, sizeof(v_int_str), "%d", vin / 10) < 2) {
+		snprintf(v_int_str, sizeof(v_int_str), "0%d", vin / 10);
+	}
+	if (snprintf(p_int_str, sizeof(p_int_str), "%d", power / 10) < 2) {
+		snprintf(p_int_str, sizeof(p_int_str), "0%d", power / 10);
+	}
+	snprintf(buf, 15, "%s.%dW    %s.%dV", p_int_str, power % 10, v_int_str,
+			 vin % 10);
+	sink = buf[0];
+	if (print) {
+		lcd_set_pos(0, 0);
+		lcd_print(buf);
+	}
+
+	// Set and actual temperatures.
+	snprintf(buf, 15, "Set:     %d%s ", set, "\x7f" "C");
+	sink = buf[0];
+	if (print) {
+		lcd_set_pos(0, 2);
+		lcd_print(buf);
+	}
+
+	snprintf(buf, 15, "Actual:  %d%s ", actual, "\x7f" "C");
+	sink = buf[0];
+	if (print) {
+		lcd_set_pos(0, 3);
+		lcd_print(buf);
+	}
+}
+
+/**
+ * The main screen lines as the firmware prints them now, with the numbers
+ * right aligned in fixed fields by the format module.
+ */
+void refresh_format(char *buf, const int power, const int vin,
+					const int actual, const int set, const bool print) {
+	// Info panel.
+	format_fixed(buf, power, 4, '0');
+	sink = buf[0];
+	if (print) {
+		lcd_set_pos(0, 0);
+		lcd_print(buf);
+		lcd_print("W   ");
+	}
+
+	format_fixed(buf, vin, 4, '0');
+	sink = buf[0];
+	if (print) {
+		lcd_print(" ");
+		lcd_print(buf);
+		lcd_putc('V');
+	}
+
+	// Set and actual temperatures.
+	format_int(buf, set, 8, ' ');
+	sink = buf[0];
+	if (print) {
+		lcd_set_pos(0, 2);
+		lcd_print("Set:");
+		lcd_print(buf);
+		lcd_print("\x7f" "C");
+	}
+
+	format_int(buf, actual, 5, ' ');
+	sink = buf[0];
+	if (print) {
+		lcd_set_pos(0, 3);
+		lcd_print("Actual:");
+		lcd_print(buf);
+		lcd_print("\x7f" "C");
+	}
+}
+
+/**
+ * Runs a bunch of refreshes, going through different values.
+ *
+ * @param refresh Refresh to run.
+ * @param count Number of refreshes.
+ * @param print Send the lines to the display?
+ */
+void run(Refresh refresh, const unsigned long count, const bool print) {
+	char buf[16];
+
+	for (unsigned long i = 0; i < count; i++) {
+		refresh(buf, i % 1000, 100 + (i % 200), 100 + (i % 350), 200 + (i % 250),
+				print);
+
+		// Let the display catch up.
+		while (print && lcd_busy()) {
+			emu_sleep(CPUOFF + GIE);
+		}
+	}
+}
+
+/**
+ * Measures a refresh and prints a row of the results table.
+ *
+ * @param name Name of the formatting.
+ * @param refresh Refresh to measure.
+ */
+void measure(const char *name, Refresh refresh) {
+	struct timespec start;
+	struct timespec end;
+	const unsigned long frames = 1000;
+
+	// Formatting alone.
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	run(refresh, REFRESHES, false);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double ns = ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) /
+		REFRESHES;
+
+	// Display traffic.
+	panel.reset_stats();
+	emu_cycles = 0;
+	run(refresh, frames, true);
+
+	printf("%-10s %12.0f %10lu %8lu %14lu\n", name, ns,
+		   panel.stats.data_bytes / frames, panel.stats.command_bytes / frames,
+		   (unsigned long)(emu_cycles / frames));
+}
+
+/**
+ * Where it all starts.
+ *
+ * @return Exit code.
+ */
+int main() {
+	emu_sr = GIE;
+	lcd_setup();
+	lcd_init();
+	lcd_flush();
+
+	printf("Main screen refresh, info panel plus the set and actual lines.\n\n");
+	printf("%-10s %12s %10s %8s %14s\n", "format", "host (ns)", "data (B)",
+		   "cmds", "bus (cycles)");
+
+	measure("snprintf", refresh_snprintf);
+	measure("format", refresh_format);
+
+	return 0;
+}
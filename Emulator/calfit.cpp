@@ -0,0 +1,310 @@
+/**
+ *    Filename: calfit.cpp
+ * Description: Fits the factory calibration to the Hakko sensor from the
+ *              SPICE model of its amplifier.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#include "settings.h"
+
+// Where the sensor amplifier lives.
+const char *asc_path = "../Simulation/Hakko Temperature Sensor.asc";
+
+// PTC sensor, a platinum-like Callendar-Van Dusen curve that goes through the
+// resistances swept in the simulation. (about 100C at 70R and 500C at 140R)
+#define PTC_R0 50.0        // Ohms at 0C.
+#define PTC_A  3.9083e-3
+#define PTC_B  -5.775e-7
+
+// Calibration the old firmware shipped with, which is what the ADC counts
+// have to line up with. (ADC, Celsius)
+#define ANCHOR_LOW_ADC   CAL_LOW_TEMP_ADC
+#define ANCHOR_LOW_TEMP  270
+#define ANCHOR_HIGH_ADC  CAL_HIGH_TEMP_ADC
+#define ANCHOR_HIGH_TEMP 415
+
+// Part values from the schematic.
+typedef struct {
+	double supply;     // V3
+	double bias_high;  // R5
+	double bias_low;   // R2
+	double ref_high;   // R6
+	double ref_low;    // R7
+	double input;      // R1
+	double feedback;   // R3
+	double sweep_from;
+	double sweep_to;
+	double sweep_step;
+} Circuit;
+
+Circuit circuit;
+
+// ADC counts = adc_offset + adc_gain * amplifier output.
+double adc_offset = 0;
+double adc_gain = 1;
+
+/**
+ * Parses a SPICE value, with its SI suffix.
+ *
+ * @param str Value string.
+ * @return Value.
+ */
+double parse_value(const char *str) {
+	char *end;
+	double value = strtod(str, &end);
+
+	switch (*end) {
+	case 'k':
+	case 'K':
+		return value * 1e3;
+	case 'M':
+		return value * 1e6;
+	case 'm':
+		return value * 1e-3;
+	case 'u':
+		return value * 1e-6;
+	}
+
+	return value;
+}
+
+/**
+ * Reads the part values from the LTspice schematic.
+ *
+ * @param path Schematic path.
+ * @return TRUE if everything the fit needs was found.
+ */
+bool read_schematic(const char *path) {
+	FILE *fh = fopen(path, "r");
+	char line[256];
+	char name[32] = "";
+	unsigned int found = 0;
+
+	if (fh == NULL) {
+		return false;
+	}
+
+	while (fgets(line, sizeof(line), fh) != NULL) {
+		char value[32];
+
+		if (sscanf(line, "SYMATTR InstName %31s", name) == 1) {
+			continue;
+		}
+
+		if (sscanf(line, "TEXT %*d %*d %*s %*d !.step param Sensor %lf %lf %lf",
+				   &circuit.sweep_from, &circuit.sweep_to, &circuit.sweep_step) == 3) {
+			found++;
+			continue;
+		}
+
+		if (sscanf(line, "SYMATTR Value %31s", value) != 1) {
+			continue;
+		}
+
+		if (strcmp(name, "V3") == 0) {
+			circuit.supply = parse_value(value);
+		} else if (strcmp(name, "R5") == 0) {
+			circuit.bias_high = parse_value(value);
+		} else if (strcmp(name, "R2") == 0) {
+			circuit.bias_low = parse_value(value);
+		} else if (strcmp(name, "R6") == 0) {
+			circuit.ref_high = parse_value(value);
+		} else if (strcmp(name, "R7") == 0) {
+			circuit.ref_low = parse_value(value);
+		} else if (strcmp(name, "R1") == 0) {
+			circuit.input = parse_value(value);
+		} else if (strcmp(name, "R3") == 0) {
+			circuit.feedback = parse_value(value);
+		} else {
+			continue;
+		}
+
+		found++;
+	}
+
+	fclose(fh);
+	return found == 8;
+}
+
+/**
+ * Resistance of the sensor.
+ *
+ * @param temp Temperature in Celsius.
+ * @return Resistance in ohms.
+ */
+double sensor_resistance(const double temp) {
+	return PTC_R0 * (1 + (PTC_A * temp) + (PTC_B * temp * temp));
+}
+
+/**
+ * Output of the amplifier, with ideal op-amps. U2 buffers half of the supply,
+ * R6/R7 halve that again for U1's non-inverting input and U1 amplifies the
+ * difference through R1, with R3 in parallel with the sensor as the feedback.
+ *
+ * @param sensor Resistance of the sensor.
+ * @return Output voltage.
+ */
+double amplifier_output(const double sensor) {
+	double bias = circuit.supply * circuit.bias_low / (circuit.bias_high + circuit.bias_low);
+	double ref = bias * circuit.ref_low / (circuit.ref_high + circuit.ref_low);
+	double feedback = circuit.feedback * sensor / (circuit.feedback + sensor);
+
+	return ref - ((bias - ref) * feedback / circuit.input);
+}
+
+/**
+ * ADC reading at a temperature.
+ *
+ * @param temp Temperature in Celsius.
+ * @return ADC counts.
+ */
+double adc_at(const double temp) {
+	return adc_offset + (adc_gain * amplifier_output(sensor_resistance(temp)));
+}
+
+/**
+ * Temperature at an ADC reading.
+ *
+ * @param adc ADC counts.
+ * @return Temperature in Celsius.
+ */
+double temp_at(const double adc) {
+	double low = -200;
+	double high = 1000;
+
+	// The curve only goes one way, so just split it in half until it's there.
+	for (uint8_t i = 0; i < 60; i++) {
+		double mid = (low + high) / 2;
+
+		if (adc_at(mid) < adc) {
+			low = mid;
+		} else {
+			high = mid;
+		}
+	}
+
+	return (low + high) / 2;
+}
+
+/**
+ * Temperature at the ends of the sweep.
+ *
+ * @param resistance Resistance of the sensor.
+ * @return Temperature in Celsius.
+ */
+double temp_at_resistance(const double resistance) {
+	double low = -200;
+	double high = 1000;
+
+	for (uint8_t i = 0; i < 60; i++) {
+		double mid = (low + high) / 2;
+
+		if (sensor_resistance(mid) < resistance) {
+			low = mid;
+		} else {
+			high = mid;
+		}
+	}
+
+	return (low + high) / 2;
+}
+
+/**
+ * Where it all starts.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments.
+ * @return Exit code.
+ */
+int main(int argc, char **argv) {
+	int fitted[CAL_POINTS];
+	int linear[CAL_POINTS];
+	double worst_linear = 0;
+	double worst_fitted = 0;
+
+	if (argc > 1) {
+		asc_path = argv[1];
+	}
+
+	if (!read_schematic(asc_path)) {
+		fprintf(stderr, "Couldn't get the sensor amplifier from %s\n", asc_path);
+		return 1;
+	}
+
+	// The ADC input stage isn't in the schematic, so scale the curve onto the
+	// old calibration. The output drops as the sensor heats up, so the gain
+	// comes out negative.
+	adc_gain = (ANCHOR_HIGH_ADC - ANCHOR_LOW_ADC) /
+		(amplifier_output(sensor_resistance(ANCHOR_HIGH_TEMP)) -
+		 amplifier_output(sensor_resistance(ANCHOR_LOW_TEMP)));
+	adc_offset = ANCHOR_LOW_ADC - (adc_gain * amplifier_output(sensor_resistance(ANCHOR_LOW_TEMP)));
+
+	printf("Sensor amplifier from %s\n\n", asc_path);
+	printf("%8s %8s %10s %8s\n", "sensor", "temp", "output", "ADC");
+	for (double r = circuit.sweep_from; r <= (circuit.sweep_to + 0.001); r += circuit.sweep_step) {
+		double temp = temp_at_resistance(r);
+
+		printf("%7.0fR %7.1fC %9.4fV %8.1f\n", r, temp, amplifier_output(r), adc_at(temp));
+	}
+
+	// Factory calibration points, and the line the old calibration drew
+	// through them.
+	for (uint8_t i = 0; i < CAL_POINTS; i++) {
+		fitted[i] = (int)floor(temp_at(CAL_POINT_ADC(i)) + 0.5);
+		linear[i] = ANCHOR_LOW_TEMP + (int)floor((((double)CAL_POINT_ADC(i) - ANCHOR_LOW_ADC) *
+			(ANCHOR_HIGH_TEMP - ANCHOR_LOW_TEMP) / (ANCHOR_HIGH_ADC - ANCHOR_LOW_ADC)) + 0.5);
+	}
+
+	// How far off each one reads across the sweep, using the firmware's own
+	// conversions.
+	printf("\n%8s %8s %12s %12s\n", "temp", "ADC", "two point", "piecewise");
+	for (int temp = (int)ceil(temp_at_resistance(circuit.sweep_from) / 25) * 25;
+			temp <= temp_at_resistance(circuit.sweep_to); temp += 25) {
+		unsigned int adc = (unsigned int)floor(adc_at(temp) + 0.5);
+		double actual = temp_at(adc);
+		double err_linear;
+		double err_fitted;
+
+		if (adc > 1023) {
+			break;
+		}
+
+		memcpy(settings.cal_var, linear, sizeof(linear));
+		perform_interpolations();
+		err_linear = conv_adc_temp(adc, CELSIUS) - actual;
+
+		memcpy(settings.cal_var, fitted, sizeof(fitted));
+		perform_interpolations();
+		err_fitted = conv_adc_temp(adc, CELSIUS) - actual;
+
+		printf("%7dC %8u %11.1fC %11.1fC\n", temp, adc, err_linear, err_fitted);
+
+		if (fabs(err_linear) > worst_linear) {
+			worst_linear = fabs(err_linear);
+		}
+		if (fabs(err_fitted) > worst_fitted) {
+			worst_fitted = fabs(err_fitted);
+		}
+	}
+
+	printf("\nWorst error: %.1fC two point, %.1fC piecewise.\n\n", worst_linear,
+		   worst_fitted);
+
+	// Ready to be pasted into settings.h.
+	printf("#define CAL_DEFAULT_TEMPS {");
+	for (uint8_t i = 0; i < CAL_POINTS; i++) {
+		printf(" %d%s", fitted[i], (i < (CAL_POINTS - 1)) ? "," : " }\n");
+	}
+
+	return 0;
+}
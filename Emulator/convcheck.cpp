@@ -0,0 +1,267 @@
+/**
+ *    Filename: convcheck.cpp
+ * Description: Checks the integer temperature conversions against the
+ *              floating point ones they replaced.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "settings.h"
+
+// The floating point conversions as they were, for a single segment.
+float adc_temp_params[2];
+float temp_adc_params[2];
+
+/**
+ * Interpolates the old conversion parameters for a calibration segment.
+ *
+ * @param temp1 Temperature at the start of the segment.
+ * @param temp2 Temperature at the end of the segment.
+ * @param adc1 ADC value at the start of the segment.
+ * @param adc2 ADC value at the end of the segment.
+ */
+void float_interpolate(const int temp1, const int temp2, const int adc1,
+					   const int adc2) {
+	adc_temp_params[0] = (float)(temp2 - temp1) / (float)(adc2 - adc1);
+	adc_temp_params[1] = temp1 - (adc_temp_params[0] * (float)adc1);
+	temp_adc_params[0] = (float)(adc2 - adc1) / (float)(temp2 - temp1);
+	temp_adc_params[1] = adc1 - (temp_adc_params[0] * (float)temp1);
+}
+
+/**
+ * Sets up the float conversion for the segment the firmware should be using.
+ *
+ * @param temps Calibration temperatures.
+ * @param seg Segment index.
+ */
+void float_segment(const int *temps, const uint8_t seg) {
+	float_interpolate(temps[seg], temps[seg + 1], CAL_POINT_ADC(seg),
+					  CAL_POINT_ADC(seg + 1));
+}
+
+/**
+ * The old ADC to temperature conversion.
+ *
+ * @param value ADC value.
+ * @param unit Temperature unit ID.
+ * @return Temperature.
+ */
+int float_adc_temp(const unsigned int value, const uint8_t unit) {
+	float temp = (adc_temp_params[0] * value) + adc_temp_params[1];
+
+	switch (unit) {
+	case FAHRENHEIT:
+		temp = (1.8 * temp) + 32;
+		break;
+	case KELVIN:
+		temp += 273.15;
+		break;
+	}
+
+	return (int)temp;
+}
+
+/**
+ * The old temperature to ADC conversion.
+ *
+ * @param temp Temperature value.
+ * @param unit Temperature unit ID.
+ * @return ADC value.
+ */
+unsigned int float_temp_adc(const int temp, const uint8_t unit) {
+	float val = (float)temp;
+
+	switch (unit) {
+	case FAHRENHEIT:
+		val = (val - 32) / 1.8;
+		break;
+	case KELVIN:
+		val -= 273.15;
+		break;
+	}
+
+	val = (temp_adc_params[0] * val) + temp_adc_params[1];
+	return (unsigned int)val;
+}
+
+/**
+ * Checks if a fraction is a whole number, which is where the float version
+ * can miss it by a hair and get truncated to the number next to it.
+ *
+ * @param num Numerator.
+ * @param den Denominator.
+ * @return TRUE if it's a whole number.
+ */
+bool is_whole(const long num, const long den) {
+	return (num % den) == 0;
+}
+
+/**
+ * Compares both conversions for every ADC value and every temperature that
+ * lands inside the ADC range, in all units, with a given calibration. The
+ * float version is a straight line through the two points around the value,
+ * just like the old firmware did with its two points.
+ *
+ * @param temps Temperature at each of the calibration points.
+ * @return Number of differences that aren't float rounding.
+ */
+unsigned int check(const int *temps) {
+	const long span = CAL_POINT_SPAN;
+	unsigned int compared = 0;
+	unsigned int rounding = 0;
+	unsigned int wrong = 0;
+
+	for (uint8_t i = 0; i < CAL_POINTS; i++) {
+		settings.cal_var[i] = temps[i];
+	}
+	perform_interpolations();
+
+	for (uint8_t unit = CELSIUS; unit <= KELVIN; unit++) {
+		// ADC to temperature.
+		for (unsigned int adc = 0; adc < 1024; adc++) {
+			uint8_t seg = 0;
+			long slope;
+			long c;
+			int got;
+			int want;
+
+			while ((seg < (CAL_POINTS - 2)) && ((int)adc >= CAL_POINT_ADC(seg + 1))) {
+				seg++;
+			}
+
+			slope = temps[seg + 1] - temps[seg];
+			if (slope == 0) {
+				continue;
+			}
+			c = ((long)temps[seg] * span) + (((long)adc - CAL_POINT_ADC(seg)) * slope);  // Celsius * span
+
+			float_segment(temps, seg);
+			got = conv_adc_temp(adc, unit);
+			want = float_adc_temp(adc, unit);
+			compared++;
+			if (got == want) {
+				continue;
+			}
+
+			// Exact result is a whole number the float missed by a hair.
+			if ((abs(got - want) == 1) &&
+					(((unit == CELSIUS) && is_whole(c, span)) ||
+					 ((unit == FAHRENHEIT) && is_whole((9 * c) + (160 * span), 5 * span)) ||
+					 ((unit == KELVIN) && is_whole((20 * c) + (5463 * span), 20 * span)))) {
+				rounding++;
+			} else {
+				printf("  segment %u unit %u: ADC %u -> %d, float %d\n", seg, unit,
+					   adc, got, want);
+				wrong++;
+			}
+		}
+
+		// Temperature to ADC, for everything that's on the scale.
+		for (int temp = -500; temp < 2500; temp++) {
+			unsigned int got = conv_temp_adc(temp, unit);
+			unsigned int want;
+			uint8_t seg = 0;
+			long celsius;
+			long scale;
+			long slope;
+			long base;
+			long num;
+			long den;
+
+			switch (unit) {
+			case FAHRENHEIT:
+				celsius = 5L * (temp - 32);
+				scale = 9;
+				break;
+			case KELVIN:
+				celsius = (20L * temp) - 5463;
+				scale = 20;
+				break;
+			default:
+				celsius = temp;
+				scale = 1;
+				break;
+			}
+
+			while ((seg < (CAL_POINTS - 2)) && (celsius >= ((long)temps[seg + 1] * scale))) {
+				seg++;
+			}
+
+			slope = temps[seg + 1] - temps[seg];
+			if (slope == 0) {
+				continue;
+			}
+			base = ((long)temps[seg] * span) - (CAL_POINT_ADC(seg) * slope);
+			num = (celsius * span) - (base * scale);
+			den = slope * scale;
+
+			// Negative values were undefined in the float version.
+			if (((double)num / den) < 0 || ((double)num / den) > 1023) {
+				continue;
+			}
+
+			float_segment(temps, seg);
+			want = float_temp_adc(temp, unit);
+			compared++;
+			if (got == want) {
+				continue;
+			}
+
+			if ((abs((int)got - (int)want) == 1) && is_whole(num, den)) {
+				rounding++;
+			} else {
+				printf("  segment %u unit %u: %d -> ADC %u, float %u\n", seg, unit,
+					   temp, got, want);
+				wrong++;
+			}
+		}
+	}
+
+	for (uint8_t i = 0; i < CAL_POINTS; i++) {
+		printf("%4d ", temps[i]);
+	}
+	printf("%9u %9u %6u\n", compared, rounding, wrong);
+
+	return wrong;
+}
+
+/**
+ * Where it all starts.
+ *
+ * @return Number of conversions that disagree for real.
+ */
+int main() {
+	const int cals[][CAL_POINTS] = {
+		CAL_DEFAULT_TEMPS,
+		{ 198, 270, 343, 415, 488 },
+		{ 175, 250, 325, 400, 475 },
+		{ 230, 300, 370, 450, 530 },
+		{ 100, 200, 350, 500, 520 },
+		{ 270, 271, 272, 273, 274 },
+		{ 495, 415, 340, 270, 204 }
+	};
+	unsigned int wrong = 0;
+
+	load_default_settings();
+
+	printf("Integer conversions against the float ones they replaced.\n\n");
+	for (uint8_t i = 0; i < CAL_POINTS; i++) {
+		printf(" %3u ", CAL_POINT_ADC(i));
+	}
+	printf("%9s %9s %6s\n", "compared", "rounding", "wrong");
+	for (unsigned int i = 0; i < (sizeof(cals) / sizeof(cals[0])); i++) {
+		wrong += check(cals[i]);
+	}
+
+	printf("\n\"rounding\" is where the exact result is a whole number and the\n");
+	printf("float version missed it by a hair and got truncated to its neighbour.\n");
+
+	return (wrong > 0) ? 1 : 0;
+}
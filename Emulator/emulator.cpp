@@ -0,0 +1,266 @@
+/**
+ *    Filename: emulator.cpp
+ * Description: Runs the LCD parts of the firmware against an emulated PCD8544,
+ *              saving every screen and accounting for the bus traffic.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#include <msp430g2553.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "hardware.h"
+#include "lcd.h"
+#include "settings.h"
+#include "screens.h"
+#include "menu.h"
+#include "timer.h"
+#include "estimator.h"
+#include "sense.h"
+#include "heater.h"
+
+// Firmware stuff that doesn't live in a header.
+extern unsigned int adc[];
+extern float adc_res;
+extern volatile unsigned int heater_duty;
+extern volatile unsigned int heater_power_avail;
+extern volatile uint8_t idle_state;
+void set_temperature(int temp, const bool print, const uint8_t unit, const bool force);
+void print_set_temperature(const uint8_t unit);
+void info_panel();
+void print_actual_temperature();
+void print_eta();
+void heater_bar();
+void diagnostics_panel();
+void diagnostics_heater(const bool on);
+void confirm_cal_panel();
+extern int cal_temp[];
+extern uint8_t bar_level;
+extern uint8_t rows_dirty;
+extern volatile uint8_t lcd_queue_peak;
+
+// Firmware constants that don't live in a header.
+#define ADC_VISENSE 2
+#define IDLE_ACTIVE  0
+#define IDLE_STANDBY 1
+
+// Output directory.
+const char *out_dir = ".";
+
+/**
+ * Drains the LCD output queue, like the CPU would while doing other stuff.
+ */
+void drain() {
+	while (lcd_busy()) {
+		emu_sleep(CPUOFF + GIE);
+	}
+}
+
+/**
+ * Starts measuring a frame.
+ */
+void frame_start() {
+	panel.reset_stats();
+	emu_cycles = 0;
+	emu_sleeps = 0;
+	lcd_queue_peak = 0;
+}
+
+/**
+ * Finishes a frame, saves it and prints the traffic it took.
+ *
+ * @param name Frame name.
+ */
+void frame_end(const char *name) {
+	char filename[256];
+	const Pcd8544Stats &st = panel.stats;
+
+	// Anything that slept while drawing was waiting for room in the queue.
+	unsigned long stalls = emu_sleeps;
+	drain();
+
+#ifdef ROTATION_ENABLE
+	const bool rotated = true;
+#else
+	const bool rotated = false;
+#endif
+
+	snprintf(filename, sizeof(filename), "%s/%s.pgm", out_dir, name);
+	panel.write_pgm(filename, rotated, 4);
+
+	printf("%-18s %6lu %6lu %6lu %6lu %8lu %9.1f %5u %6lu\n", name,
+		   st.data_bytes, st.command_bytes, st.address_commands, st.packets,
+		   st.pin_writes,
+		   (st.pin_writes * CYCLES_PER_PORT_WRITE * 1e6) / CPU_FREQ_HZ,
+		   lcd_queue_peak, stalls);
+
+	if (st.invalid_addresses) {
+		printf("%-18s %lu invalid address commands!\n", "", st.invalid_addresses);
+	}
+}
+
+/**
+ * Emulates the main screen drawing done by the main loop.
+ *
+ * @param setup Is this the screen setup?
+ */
+void main_screen(const bool setup) {
+	if (setup) {
+		change_screen(MAIN_SCREEN);
+		set_temperature(conv_adc_temp(settings.last_set_temp + 1), true,
+						settings.temp_unit, true);
+		bar_level = 0xFF;  // BAR_REDRAW
+		rows_dirty = 0xFF;  // ROWS_ALL
+	}
+
+	info_panel();
+	print_actual_temperature();
+	print_eta();
+	heater_bar();
+}
+
+/**
+ * Where it all starts.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments.
+ * @return Exit code.
+ */
+int main(int argc, char **argv) {
+	unsigned int sensed;
+
+	if (argc > 1) {
+		out_dir = argv[1];
+	}
+
+	// Get the firmware into a known state.
+	emu_sr = GIE;
+	load_default_settings();
+	adc_res = settings.vref / 1023.0;
+	adc[ADC_VISENSE] = 352;  // ~12V
+	sensed = SENSE_FINE(conv_temp_adc(300, CELSIUS));
+	sense_filter_reset(sensed);
+
+	printf("%-18s %6s %6s %6s %6s %8s %9s %5s %6s\n", "frame", "data", "cmds",
+		   "addr", "pkts", "pins", "bus (us)", "queue", "stalls");
+
+	frame_start();
+	lcd_setup();
+	lcd_init();
+	lcd_clear();
+	frame_end("init");
+
+	frame_start();
+	splash_screen();
+	frame_end("splash");
+
+	frame_start();
+	main_screen(true);
+	frame_end("main-setup");
+
+	frame_start();
+	main_screen(false);
+	frame_end("main-idle");
+
+	frame_start();
+	heater_duty = 250;
+	heater_power_avail = PWM_PERIOD;
+	estimator_reset(SENSE_FINE(conv_temp_adc(200, CELSIUS)));
+	main_screen(false);
+	frame_end("main-heating");
+
+	frame_start();
+	heater_duty = 270;
+	sense_filter_reset(++sensed);
+	main_screen(false);
+	frame_end("main-step");
+
+	// A single spike at the top of the scale is thrown away, but the second
+	// one in a row means the iron was pulled out.
+	frame_start();
+	sense_filter(SENSE_OPEN);
+	main_screen(false);
+	frame_end("main-spike");
+
+	frame_start();
+	sense_filter(SENSE_OPEN);
+	main_screen(false);
+	frame_end("main-open");
+	sense_filter_reset(sensed);
+
+	frame_start();
+	idle_state = IDLE_STANDBY;
+	print_set_temperature(settings.temp_unit);
+	main_screen(false);
+	frame_end("main-standby");
+	idle_state = IDLE_ACTIVE;
+
+	frame_start();
+	change_screen(MENU_SCREEN);
+	load_menu_screen(MENU_MAIN, 0);
+	frame_end("menu");
+
+	frame_start();
+	load_menu_screen(MENU_CURRENT, 1);
+	frame_end("menu-scroll");
+
+	frame_start();
+	for (uint8_t i = 0; i < 4; i++) {
+		load_menu_screen(MENU_CURRENT, 1);
+	}
+	frame_end("menu-last");
+
+	frame_start();
+	load_menu_screen(MENU_POWER, 0);
+	frame_end("menu-power");
+
+	frame_start();
+	load_menu_screen(MENU_TEMPPRESETS, 0);
+	frame_end("menu-presets");
+
+	frame_start();
+	load_menu_screen(MENU_CALIBRATION, 0);
+	frame_end("menu-calibration");
+
+	frame_start();
+	change_screen(DIAGNOSTICS_SCREEN);
+	diagnostics_heater(false);
+	sense_reset();
+	sense_add_reading(24, SENSE_MIN_ORDER);
+	sense_budget(SENSE_FINE(settings.last_set_temp), SENSE_FINE(settings.last_set_temp));
+	sample_rate = 1000;
+	control_rate = CONTROL_RATE_HZ;
+	render_rate = RENDER_RATE_HZ;
+	diagnostics_panel();
+	frame_end("diagnostics");
+
+	frame_start();
+	diagnostics_heater(true);
+	frame_end("diagnostics-heater");
+
+	frame_start();
+	change_screen(CONFIRM_CAL_SCREEN);
+	lcd_print("  Calibrated  ", INVERTED);
+	for (uint8_t i = 0; i < CAL_POINTS; i++) {
+		cal_temp[i] = settings.cal_var[i];
+	}
+	confirm_cal_panel();
+	frame_end("calibrated");
+
+	frame_start();
+	change_screen(ABOUT_SCREEN);
+	about_screen();
+	frame_end("about");
+
+	frame_start();
+	change_screen(RECOVERY_SCREEN);
+	recovery_screen();
+	frame_end("recovery");
+
+	return 0;
+}
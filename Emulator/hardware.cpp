@@ -0,0 +1,93 @@
+/**
+ *    Filename: hardware.cpp
+ * Description: Emulated MSP430G2553 registers and CPU bits.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#include "msp430g2553.h"
+#include "hardware.h"
+#include <stddef.h>
+
+// Emulated hardware.
+Pcd8544 panel;
+uint64_t emu_cycles = 0;
+unsigned long emu_sleeps = 0;
+unsigned int emu_sr = 0;
+
+// Registers.
+#define EMU_DEF8(name)  volatile unsigned char name = 0;
+#define EMU_DEF16(name) volatile unsigned int name = 0;
+
+EMU_DEF8(P1OUT) EMU_DEF8(P1DIR) EMU_DEF8(P1SEL) EMU_DEF8(P1SEL2)
+EMU_DEF8(P1IE) EMU_DEF8(P1IES) EMU_DEF8(P1IFG) EMU_DEF8(P1REN)
+EMU_DEF8(P2DIR) EMU_DEF8(P2SEL) EMU_DEF8(P2SEL2) EMU_DEF8(P2IN)
+EMU_DEF8(P2IE) EMU_DEF8(P2IES) EMU_DEF8(P2IFG) EMU_DEF8(P2REN)
+volatile unsigned char P1IN = 0xFF;  // Button released.
+
+EMU_DEF8(BCSCTL1) EMU_DEF8(BCSCTL2) EMU_DEF8(BCSCTL3) EMU_DEF8(DCOCTL)
+EMU_DEF8(CALBC1_16MHZ) EMU_DEF8(CALDCO_16MHZ)
+EMU_DEF16(WDTCTL)
+
+EMU_DEF16(ADC10CTL0) EMU_DEF16(ADC10CTL1) EMU_DEF8(ADC10AE0)
+EMU_DEF8(ADC10DTC0) EMU_DEF8(ADC10DTC1) EMU_DEF16(ADC10SA) EMU_DEF16(ADC10MEM)
+
+EMU_DEF16(TA0CTL) EMU_DEF16(TA0R) EMU_DEF16(TA0IV)
+EMU_DEF16(TA0CCTL0) EMU_DEF16(TA0CCTL1) EMU_DEF16(TA0CCTL2)
+EMU_DEF16(TA0CCR0) EMU_DEF16(TA0CCR1) EMU_DEF16(TA0CCR2)
+EMU_DEF16(TA1CTL) EMU_DEF16(TA1R) EMU_DEF16(TA1IV)
+EMU_DEF16(TA1CCTL0) EMU_DEF16(TA1CCTL1) EMU_DEF16(TA1CCTL2)
+EMU_DEF16(TA1CCR0) EMU_DEF16(TA1CCR1) EMU_DEF16(TA1CCR2)
+
+EMU_DEF8(UCB0CTL0) EMU_DEF8(UCB0CTL1) EMU_DEF8(UCB0BR0) EMU_DEF8(UCB0BR1)
+EMU_DEF16(UCB0I2CSA) EMU_DEF8(UCB0I2CIE) EMU_DEF8(UCB0STAT)
+EMU_DEF8(UCB0TXBUF) EMU_DEF8(UCB0RXBUF) EMU_DEF8(IFG2) EMU_DEF8(IE2)
+
+/**
+ * Forwards the LCD pins to the emulated controller.
+ *
+ * @param value New state of the port.
+ */
+void p2out_changed(uint8_t value) {
+	panel.pins(value);
+}
+
+Port P2OUT(p2out_changed);
+
+/**
+ * Sets the value of the port and tells whoever is listening.
+ *
+ * @param v New value.
+ */
+void Port::set(const unsigned int v) {
+	value = v;
+	emu_cycles += CYCLES_PER_PORT_WRITE;
+
+	if (hook != NULL) {
+		hook(value);
+	}
+}
+
+/**
+ * Runs the interrupts that would wake the CPU when it goes to sleep. Only the
+ * ones the emulator knows about are serviced, everything else returns right
+ * away so the firmware can't hang.
+ *
+ * @param bits Status register bits being set.
+ */
+void emu_sleep(const unsigned int bits) {
+	emu_sr |= (bits & GIE);
+	if (!(bits & CPUOFF)) {
+		return;
+	}
+	emu_sleeps++;
+
+	// LCD output queue.
+	if (TA1CCTL1 & CCIE) {
+		TA1IV = TA1IV_TACCR1;
+		Timer1_A1_ISR();
+		TA1IV = 0;
+	}
+}
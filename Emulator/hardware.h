@@ -0,0 +1,25 @@
+/**
+ *    Filename: hardware.h
+ * Description: Emulated MSP430G2553 registers and CPU bits.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#ifndef EMU_HARDWARE_H_
+#define EMU_HARDWARE_H_
+
+#include "pcd8544.h"
+
+// Clock and rough cost of a read-modify-write to a port (BIS/BIC to &P2OUT).
+#define CPU_FREQ_HZ           16000000UL
+#define CYCLES_PER_PORT_WRITE 4
+
+// Emulated hardware.
+extern Pcd8544 panel;
+
+// Firmware interrupt service routines we know how to fire.
+void Timer1_A1_ISR(void);
+
+#endif /* EMU_HARDWARE_H_ */
@@ -0,0 +1,792 @@
+/**
+ *    Filename: heatersim.cpp
+ * Description: Simulates the heater of a Hakko 907 iron being driven by the
+ *              firmware's controller, to compare how controllers behave.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#include "settings.h"
+#include "heater.h"
+#include "pid.h"
+#include "autotune.h"
+#include "estimator.h"
+#include "sense.h"
+#include "screens.h"
+
+// Firmware stuff that doesn't live in a header.
+extern unsigned int adc[];
+extern unsigned int set_temp;
+extern volatile unsigned int actual_temp;
+extern volatile unsigned int heater_pwm;
+extern volatile unsigned int heater_duty;
+extern volatile unsigned int heater_power_avail;
+extern bool heater_unsafe;
+extern uint8_t sense_run;
+extern unsigned int vin_nominal;
+extern volatile unsigned int boost_timeout;
+extern volatile uint8_t idle_state;
+extern bool idle_settled;
+extern unsigned int adc_sum[];
+extern uint8_t adc_blocks;
+extern uint8_t adc_order;
+extern unsigned int adc_jitter;
+extern uint8_t reading_order;
+extern volatile bool adc_fresh;
+extern volatile bool adc_tainted;
+void update_power_limit();
+void start_boost();
+void adc_read_block(const unsigned int *block);
+
+// Firmware constants that don't live in a header.
+#define SAMPLE_PERIOD  (CONTROL_PERIOD_MS / 1000.0)  // Time between control runs.
+#define ADC_SENSOR     0
+#define ADC_VISENSE    2
+#define IDLE_ACTIVE    0
+
+// Time the ADC takes to fill a DTC block.
+#define BLOCK_PERIOD ((double)(ADC_BLOCK_SEQS * SENSE_SEQ_CYCLES) / SMCLK_HZ)
+
+// Budget the controllers that don't run in the firmware read the sensor with.
+// (2^n sequences)
+#define FIXED_ORDER 4
+
+// How often the v1.0 main loop got around to running the controller, with
+// the blocking ADC reads and the whole screen being redrawn every time.
+#define V1_LOOP_PERIOD 0.015
+#define V1_SENSE_TIME  0.0016  // Heater was turned off while reading the ADC.
+
+// Simulation step.
+#define SIM_STEP 0.0005
+
+// Ambient temperature.
+#define T_AMBIENT 25.0
+
+// Power ceiling of the weak brick, and when the joint is soldered with it.
+// Heating up takes a lot longer on it, so the joint comes later to have the
+// ripple taken once it settled.
+#define LIMITED_WATTS      30
+#define LIMITED_LOAD_START 80.0
+
+// Setpoint of the supply sweep, and when the joint is soldered in it. On the
+// weaker supplies it takes well over a minute to get there.
+#define SUPPLY_SETPOINT   250.0
+#define SUPPLY_LOAD_START 150.0
+
+/**
+ * Thermal model of the iron. The sensor lives inside the ceramic heater and
+ * lags behind the heater winding, which heats the tip through a thermal
+ * resistance, and the tip loses heat to the air and to whatever it's touching.
+ */
+struct Iron {
+	double vin;        // Supply voltage.
+	double rheater;    // Heater resistance.
+	double c_heater;   // Heater heat capacity (J/K).
+	double c_tip;      // Tip heat capacity (J/K).
+	double g_coupling; // Heater to tip conductance (W/K).
+	double g_air;      // Tip to air conductance (W/K).
+	double g_load;     // Tip to joint conductance while soldering (W/K).
+	double tau_sensor; // Sensor time constant (s).
+
+	double t_heater;
+	double t_sensor;
+	double t_tip;
+};
+
+/**
+ * Scenario results.
+ */
+struct Results {
+	double heatup;     // Time to get within 5C of the setpoint.
+	double overshoot;  // Peak above the setpoint after heating up.
+	double ripple;     // Peak to peak in steady state.
+	double droop;      // Largest drop while soldering.
+	double recovery;   // Time to get back within 5C after the joint.
+	double energy;     // Energy delivered during the whole run.
+	double peak;       // Highest power drawn from the supply.
+};
+
+// Controllers.
+typedef unsigned int (*Controller)(const unsigned int setpoint,
+								   const unsigned int measured);
+
+unsigned int bang_pwm = 0;
+
+// Supply voltage as the firmware would read it. (ADC counts)
+unsigned int sim_vin_adc = 0;
+
+// What the firmware's control loop did with the readings.
+unsigned long sim_periods = 0;
+unsigned long sim_readings = 0;
+unsigned int sim_eta = 0;       // Time to the setpoint predicted 5s in.
+unsigned long sim_samples = 0;  // Samples in the readings that were used.
+uint8_t sim_steady_order = 0;   // Budget right before the joint.
+
+// Throw away the oversampling, like the firmware did before it.
+bool sim_coarse = false;
+
+// Noise of a single sample. (ADC counts)
+double sim_noise = 0.5;
+
+// Chance of a sample being caught by a switching spike and reading the top of
+// the scale.
+double sim_spikes = 0;
+
+// How much the readings and what would be shown move around right before the
+// joint. (fine counts)
+unsigned int sim_raw_min = 0xFFFF;
+unsigned int sim_raw_max = 0;
+unsigned int sim_shown_min = 0xFFFF;
+unsigned int sim_shown_max = 0;
+
+/**
+ * The original ramp controller, +10 when below and -100 when above.
+ */
+unsigned int control_bang(const unsigned int setpoint,
+						  const unsigned int measured) {
+	if (measured < setpoint) {
+		if (bang_pwm < PWM_PERIOD) {
+			bang_pwm += 10;
+		}
+	} else {
+		if (bang_pwm > 100) {
+			bang_pwm -= 100;
+		} else {
+			bang_pwm = 0;
+		}
+	}
+
+	return (bang_pwm > SENSE_MAX_DUTY) ? SENSE_MAX_DUTY : bang_pwm;
+}
+
+/**
+ * The original controller as it ran in v1.0, without the sensing cap but
+ * with the heater being turned off for every ADC read.
+ */
+unsigned int control_bang_v1(const unsigned int setpoint,
+							 const unsigned int measured) {
+	control_bang(setpoint, measured);
+	return (unsigned int)(bang_pwm * (1.0 - (V1_SENSE_TIME / V1_LOOP_PERIOD)));
+}
+
+/**
+ * The firmware's PID controller.
+ */
+unsigned int control_pid(const unsigned int setpoint,
+						 const unsigned int measured) {
+	return pid_update(setpoint, measured, SENSE_MAX_DUTY);
+}
+
+/**
+ * The firmware's PID controller commanding power, with the supply voltage
+ * feed-forward.
+ */
+unsigned int control_pid_ff(const unsigned int setpoint,
+							const unsigned int measured) {
+	pid_set_supply(sim_vin_adc, vin_nominal);
+	return pid_dither_duty(pid_update(setpoint, measured,
+									  pid_max_power(SENSE_MAX_DUTY)));
+}
+
+/**
+ * The firmware's own control loop, running on the readings the ADC blocks fed
+ * to it since the last period. The arguments are only there to fit in with the
+ * other controllers, it has its own setpoint and readings.
+ *
+ * @param setpoint Ignored.
+ * @param measured Ignored.
+ * @return Duty cycle sent to the heater.
+ */
+unsigned int control_firmware(const unsigned int /* setpoint */,
+							  const unsigned int /* measured */) {
+	bool fresh = adc_fresh;
+
+	// Keep track of the readings the loop is about to use.
+	if (fresh) {
+		sim_readings++;
+		sim_samples += 1UL << reading_order;
+	}
+
+	control_tick();
+
+	// Steady state, right before the joint.
+	if (fresh && (sim_periods >= (40U * CONTROL_RATE_HZ)) &&
+			(sim_periods < (45U * CONTROL_RATE_HZ))) {
+		unsigned int raw = adc[ADC_SENSOR];
+		unsigned int shown = sense_display_temp();
+
+		sim_raw_min = (raw < sim_raw_min) ? raw : sim_raw_min;
+		sim_raw_max = (raw > sim_raw_max) ? raw : sim_raw_max;
+		sim_shown_min = (shown < sim_shown_min) ? shown : sim_shown_min;
+		sim_shown_max = (shown > sim_shown_max) ? shown : sim_shown_max;
+	}
+
+	if (++sim_periods == (5U * CONTROL_RATE_HZ)) {
+		sim_eta = estimator_eta(SENSE_FINE(set_temp), heater_power_avail);
+	} else if (sim_periods == (44U * CONTROL_RATE_HZ)) {
+		sim_steady_order = reading_order;
+	}
+
+	return heater_duty;
+}
+
+/**
+ * Gets the firmware's control loop to where it would be on the main screen
+ * right after being turned on, with a cold iron.
+ *
+ * @param setpoint Target temperature in ADC counts.
+ * @param reading First reading of the sensor in fine counts.
+ */
+void firmware_reset(const unsigned int setpoint, const unsigned int reading) {
+	current_screen = MAIN_SCREEN;
+	screen_setup = false;
+	idle_state = IDLE_ACTIVE;
+	idle_settled = false;
+	set_temp = setpoint;
+
+	// Controller, model and filters.
+	pid_reset(reading);
+	estimator_reset(reading);
+	sense_reset();
+	sense_filter_reset(reading);
+	actual_temp = reading;
+	heater_pwm = 0;
+	heater_duty = 0;
+	heater_unsafe = false;
+	sense_run = 0;
+
+	// ADC, starting a new reading.
+	adc_sum[0] = 0;
+	adc_sum[1] = 0;
+	adc_jitter = 0;
+	adc_blocks = 0;
+	adc_order = sense_order();
+	adc_fresh = false;
+	adc_tainted = false;
+
+	// Power ceiling, boosting if the settings allow it.
+	boost_timeout = 0;
+	update_power_limit();
+	start_boost();
+
+	sim_periods = 0;
+	sim_readings = 0;
+	sim_samples = 0;
+	sim_raw_min = 0xFFFF;
+	sim_raw_max = 0;
+	sim_shown_min = 0xFFFF;
+	sim_shown_max = 0;
+}
+
+/**
+ * Converts a supply voltage to what the ADC would read.
+ *
+ * @param vin Supply voltage.
+ * @return ADC reading.
+ */
+unsigned int vin_to_adc(const double vin) {
+	return (unsigned int)((vin * settings.vin_ratio) / (settings.vref / 1023.0));
+}
+
+/**
+ * Converts a sensor temperature to what the ADC would read, using the
+ * default calibration.
+ *
+ * @param temp Temperature in Celsius.
+ * @return ADC reading.
+ */
+double temp_to_adc(const double temp) {
+	return CAL_LOW_TEMP_ADC + ((temp - 270.0) *
+		(CAL_HIGH_TEMP_ADC - CAL_LOW_TEMP_ADC) / (415.0 - 270.0));
+}
+
+/**
+ * Converts a difference in fine counts to Celsius, using the default
+ * calibration.
+ *
+ * @param fine Difference in fine counts.
+ * @return Difference in Celsius.
+ */
+double fine_to_celsius(const unsigned int fine) {
+	return (fine / (double)SENSE_FINE(1)) * (415.0 - 270.0) /
+		(CAL_HIGH_TEMP_ADC - CAL_LOW_TEMP_ADC);
+}
+
+/**
+ * Gaussian noise.
+ *
+ * @return Random number with zero mean and unit variance.
+ */
+double noise() {
+	double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+	double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+
+	return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+/**
+ * Converts a sample like the ADC does, with noise and the odd switching spike.
+ *
+ * @param adc What the ADC would read without any noise.
+ * @return Conversion result.
+ */
+unsigned int sample(const double adc) {
+	double value = adc + (sim_noise * noise());
+	unsigned int conv = (value < 0) ? 0 : (unsigned int)(value + 0.5);
+
+	if ((sim_spikes > 0) && (rand() < (sim_spikes * RAND_MAX))) {
+		return 1023;
+	}
+
+	return (conv > 1023) ? 1023 : conv;
+}
+
+/**
+ * Takes a reading of the sensor for the controllers that don't run in the
+ * firmware, summing 2^FIXED_ORDER noisy conversions and decimating them into
+ * fine counts.
+ *
+ * @param adc What the ADC would read without any noise.
+ * @return Reading in fine counts.
+ */
+unsigned int sense(const double adc) {
+	unsigned int sum = 0;
+
+	for (unsigned int i = 0; i < (1U << FIXED_ORDER); i++) {
+		sum += sample(adc);
+	}
+
+	if (sim_coarse) {
+		return SENSE_FINE(sum >> FIXED_ORDER);
+	}
+
+	return sum >> (FIXED_ORDER - SENSE_FRAC_BITS);
+}
+
+/**
+ * Hands the firmware a DTC block full of conversions, like the ADC interrupt
+ * does. The heater being on in the sense window throws the sensor to the top
+ * of the scale.
+ *
+ * @param adc What the ADC would read from the sensor without any noise.
+ */
+void feed_block(const double adc) {
+	unsigned int block[ADC_BLOCK_SEQS * ADC_CONVS];
+
+	memset(block, 0, sizeof(block));
+	for (uint8_t i = 0; i < ADC_BLOCK_SEQS; i++) {
+		block[(i * ADC_CONVS) + ADC_SENSOR] =
+			(heater_duty > SENSE_MAX_DUTY) ? 1023 : sample(adc);
+		block[(i * ADC_CONVS) + ADC_VISENSE] = sim_vin_adc;
+	}
+
+	adc_read_block(block);
+}
+
+/**
+ * Heats the iron up, lets it settle and then solders a big joint for 3s. The
+ * ripple is taken in the 5s before the joint, so it has to be late enough for
+ * the iron to have settled by then.
+ *
+ * @param iron Iron to simulate.
+ * @param control Controller to use.
+ * @param period How often the controller runs.
+ * @param setpoint Target temperature in Celsius.
+ * @param load_start When the joint is soldered.
+ * @param trace File to write a trace into, or NULL.
+ * @return Results of the run.
+ */
+Results run(Iron iron, Controller control, const double period,
+			const double setpoint, const double load_start, FILE *trace) {
+	Results res;
+	const double load_end = load_start + 3.0;
+	const double duration = load_start + 25.0;
+	unsigned int set_adc = SENSE_FINE((unsigned int)(temp_to_adc(setpoint) + 0.5));
+	unsigned int duty = 0;
+	bool firmware = (control == control_firmware);
+	double next_sample = 0;
+	double next_block = 0;
+	double ss_min = 1e9;
+	double ss_max = -1e9;
+	bool reached = false;
+
+	memset(&res, 0, sizeof(res));
+	res.heatup = -1;
+	res.recovery = -1;
+	srand(1);
+
+	iron.t_heater = T_AMBIENT;
+	iron.t_sensor = T_AMBIENT;
+	iron.t_tip = T_AMBIENT;
+	sim_vin_adc = vin_to_adc(iron.vin);
+	bang_pwm = 0;
+	if (firmware) {
+		firmware_reset(SENSE_COARSE(set_adc), sense(temp_to_adc(T_AMBIENT)));
+	} else {
+		pid_reset(sense(temp_to_adc(T_AMBIENT)));
+	}
+
+	for (double t = 0; t < duration; t += SIM_STEP) {
+		// The ADC runs on its own, a block at a time.
+		if (firmware && (t >= next_block)) {
+			feed_block(temp_to_adc(iron.t_sensor));
+			next_block += BLOCK_PERIOD;
+		}
+
+		// Controller runs every time there's a new reading.
+		if (t >= next_sample) {
+			duty = control(set_adc, sense(temp_to_adc(iron.t_sensor)));
+			next_sample += period;
+
+			if (trace != NULL) {
+				fprintf(trace, "%.3f %.2f %.2f %.2f %u\n", t, iron.t_heater,
+						iron.t_sensor, iron.t_tip, duty);
+			}
+		}
+
+		// Thermal model.
+		double power = (iron.vin * iron.vin / iron.rheater) * duty / PWM_PERIOD;
+		double flow = iron.g_coupling * (iron.t_heater - iron.t_tip);
+		double loss = iron.g_air * (iron.t_tip - T_AMBIENT);
+		if ((t >= load_start) && (t < load_end)) {
+			loss += iron.g_load * (iron.t_tip - T_AMBIENT);
+		}
+
+		iron.t_heater += (power - flow) * SIM_STEP / iron.c_heater;
+		iron.t_tip += (flow - loss) * SIM_STEP / iron.c_tip;
+		iron.t_sensor += (iron.t_heater - iron.t_sensor) * SIM_STEP / iron.tau_sensor;
+		res.energy += power * SIM_STEP;
+		if (power > res.peak) {
+			res.peak = power;
+		}
+
+		// Heating up.
+		if (!reached && (iron.t_sensor >= (setpoint - 5.0))) {
+			res.heatup = t;
+			reached = true;
+		}
+
+		if (reached && (t < load_start) && ((iron.t_sensor - setpoint) > res.overshoot)) {
+			res.overshoot = iron.t_sensor - setpoint;
+		}
+
+		// Steady state ripple.
+		if ((t > (load_start - 5.0)) && (t < load_start)) {
+			if (iron.t_sensor < ss_min) {
+				ss_min = iron.t_sensor;
+			}
+			if (iron.t_sensor > ss_max) {
+				ss_max = iron.t_sensor;
+			}
+		}
+
+		// Soldering the joint.
+		if (t >= load_start) {
+			if ((setpoint - iron.t_sensor) > res.droop) {
+				res.droop = setpoint - iron.t_sensor;
+			}
+
+			if ((t >= load_end) && (res.recovery < 0) &&
+					(fabs(iron.t_sensor - setpoint) < 5.0)) {
+				res.recovery = t - load_end;
+			}
+		}
+	}
+
+	res.ripple = ss_max - ss_min;
+	return res;
+}
+
+/**
+ * Heats the iron up, lets it settle and then solders a big joint at 45s.
+ *
+ * @param iron Iron to simulate.
+ * @param control Controller to use.
+ * @param period How often the controller runs.
+ * @param setpoint Target temperature in Celsius.
+ * @param trace File to write a trace into, or NULL.
+ * @return Results of the run.
+ */
+Results run(Iron iron, Controller control, const double period,
+			const double setpoint, FILE *trace) {
+	return run(iron, control, period, setpoint, 45.0, trace);
+}
+
+/**
+ * Gets how much more power the heater can give than the iron loses at a
+ * temperature, with the heater off while sensing.
+ *
+ * @param iron Iron to simulate.
+ * @param temp Temperature in Celsius.
+ * @return Spare power in W, negative if it can't get there.
+ */
+double power_margin(const Iron &iron, const double temp) {
+	double max = (iron.vin * iron.vin / iron.rheater) * SENSE_MAX_DUTY / PWM_PERIOD;
+	return max - (iron.g_air * (temp - T_AMBIENT));
+}
+
+/**
+ * Checks if the supply is strong enough to hold a temperature at all.
+ *
+ * @param iron Iron to simulate.
+ * @param temp Temperature in Celsius.
+ * @return TRUE if the heater can keep up with the losses there.
+ */
+bool can_hold(const Iron &iron, const double temp) {
+	return power_margin(iron, temp) > 0;
+}
+
+/**
+ * Runs the firmware's loop on a brick with a power ceiling.
+ *
+ * @param iron Iron to simulate.
+ * @param boost Can it go over the ceiling while heating up?
+ * @return Results of the run.
+ */
+Results run_limited(const Iron &iron, const bool boost) {
+	uint8_t boost_time = settings.boost_time;
+	Results res;
+
+	settings.max_watts = LIMITED_WATTS;
+	settings.boost_time = boost ? DEFAULT_BOOST_TIME : 0;
+	res = run(iron, control_firmware, SAMPLE_PERIOD, 350.0, LIMITED_LOAD_START, NULL);
+	settings.max_watts = MAX_WATTS_LIMIT;
+	settings.boost_time = boost_time;
+
+	return res;
+}
+
+/**
+ * Runs the relay autotune experiment around a setpoint, leaving the gains it
+ * found in the settings.
+ *
+ * @param iron Iron to simulate.
+ * @param setpoint Target temperature in Celsius.
+ * @return Time the experiment took, negative if it failed.
+ */
+double autotune(Iron iron, const double setpoint) {
+	unsigned int duty = 0;
+	double next_sample = 0;
+	double t;
+
+	srand(1);
+	iron.t_heater = T_AMBIENT;
+	iron.t_sensor = T_AMBIENT;
+	iron.t_tip = T_AMBIENT;
+	sim_vin_adc = vin_to_adc(iron.vin);
+	autotune_start((unsigned int)(temp_to_adc(setpoint) + 0.5));
+
+	for (t = 0; autotune_state == AUTOTUNE_RUNNING; t += SIM_STEP) {
+		if (t >= next_sample) {
+			pid_set_supply(sim_vin_adc, vin_nominal);
+			duty = pid_power_to_duty(autotune_update(SENSE_COARSE(sense(temp_to_adc(iron.t_sensor))),
+													 pid_max_power(SENSE_MAX_DUTY)));
+			next_sample += SAMPLE_PERIOD;
+		}
+
+		double power = (iron.vin * iron.vin / iron.rheater) * duty / PWM_PERIOD;
+		double flow = iron.g_coupling * (iron.t_heater - iron.t_tip);
+		double loss = iron.g_air * (iron.t_tip - T_AMBIENT);
+		iron.t_heater += (power - flow) * SIM_STEP / iron.c_heater;
+		iron.t_tip += (flow - loss) * SIM_STEP / iron.c_tip;
+		iron.t_sensor += (iron.t_heater - iron.t_sensor) * SIM_STEP / iron.tau_sensor;
+	}
+
+	// The firmware does this from the main loop.
+	if (autotune_state == AUTOTUNE_MEASURED) {
+		autotune_finish();
+	}
+
+	return (autotune_state == AUTOTUNE_DONE) ? t : -1;
+}
+
+/**
+ * Prints a row of the results table.
+ *
+ * @param name Scenario name.
+ * @param res Results.
+ */
+void print_results(const char *name, const Results &res) {
+	printf("%-22s %8.1f %9.1f %7.1f %6.1f %9.1f %7.0f %5.1f\n", name,
+		   res.heatup, res.overshoot, res.ripple, res.droop, res.recovery,
+		   res.energy, res.peak);
+}
+
+/**
+ * Where it all starts.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments.
+ * @return Exit code.
+ */
+int main(int argc, char **argv) {
+	Iron iron;
+
+	// Hakko 907 with a medium chisel tip.
+	iron.vin = 24.0;
+	iron.rheater = 12.36;
+	iron.c_heater = 1.5;
+	iron.c_tip = 1.5;
+	iron.g_coupling = 0.7;
+	iron.g_air = 0.06;
+	iron.g_load = 0.15;
+	iron.tau_sensor = 2.5;
+	iron.t_heater = T_AMBIENT;
+	iron.t_sensor = T_AMBIENT;
+	iron.t_tip = T_AMBIENT;
+
+	load_default_settings();
+	settings.max_watts = MAX_WATTS_LIMIT;  // Only the brick below has a ceiling.
+	vin_nominal = vin_to_adc(PID_VIN_NOMINAL);
+
+	// Only the droop of the firmware's own loop, so that builds with different
+	// options can be compared.
+	if ((argc == 2) && (strcmp(argv[1], "--droop") == 0)) {
+		printf("%.1f\n", run(iron, control_firmware, SAMPLE_PERIOD, 350.0, NULL).droop);
+		return 0;
+	}
+
+	// Slowest heat up and worst ripple of the supply feed-forward, on the
+	// supplies that can hold the setpoint.
+	if ((argc == 2) && (strcmp(argv[1], "--supply") == 0)) {
+		double heatup = 0;
+		double ripple = 0;
+
+		for (int vin = 24; vin >= 12; vin -= 3) {
+			Iron weak = iron;
+			weak.vin = vin;
+			if (!can_hold(weak, SUPPLY_SETPOINT)) {
+				continue;
+			}
+
+			Results res = run(weak, control_pid_ff, SAMPLE_PERIOD,
+							  SUPPLY_SETPOINT, SUPPLY_LOAD_START, NULL);
+			if ((res.heatup < 0) || (heatup < 0)) {
+				heatup = -1;
+			} else {
+				heatup = fmax(heatup, res.heatup);
+			}
+			ripple = fmax(ripple, res.ripple);
+		}
+
+		printf("%.1f %.1f\n", heatup, ripple);
+		return 0;
+	}
+
+	// Worst ripple of the firmware's loop under a power ceiling.
+	if ((argc == 2) && (strcmp(argv[1], "--ripple") == 0)) {
+		printf("%.1f\n", fmax(run_limited(iron, false).ripple,
+							  run_limited(iron, true).ripple));
+		return 0;
+	}
+
+	// Allow the gains to be played with from the command line.
+	if (argc > 3) {
+		settings.pid_kp = atoi(argv[1]);
+		settings.pid_ki = atoi(argv[2]);
+		settings.pid_kd = atoi(argv[3]);
+	}
+
+	printf("Heating up to 350C, soldering a big joint at 45s for 3s.\n");
+	printf("Gains: Kp=%u Ki=%u Kd=%u\n\n", settings.pid_kp, settings.pid_ki,
+		   settings.pid_kd);
+	printf("%-22s %8s %9s %7s %6s %9s %7s %5s\n", "controller", "heatup",
+		   "overshoot", "ripple", "droop", "recovery", "energy", "peak");
+	printf("%-22s %8s %9s %7s %6s %9s %7s %5s\n", "", "(s)", "(C)", "(C)",
+		   "(C)", "(s)", "(J)", "(W)");
+
+	print_results("bang-bang (v1.0 loop)",
+				  run(iron, control_bang_v1, V1_LOOP_PERIOD, 350.0, NULL));
+	print_results("bang-bang", run(iron, control_bang, SAMPLE_PERIOD, 350.0, NULL));
+	print_results("pid", run(iron, control_pid, SAMPLE_PERIOD, 350.0, NULL));
+	sim_coarse = true;
+	print_results("pid (10-bit)", run(iron, control_pid, SAMPLE_PERIOD, 350.0, NULL));
+	sim_coarse = false;
+
+	// The firmware's own control loop, only sensing when the estimator needs
+	// it and picking the sample budget on the fly, on a quiet and a noisy
+	// sensor.
+	for (uint8_t noisy = 0; noisy < 2; noisy++) {
+		sim_noise = noisy ? 2.0 : 0.5;
+
+		Results est = run(iron, control_firmware, SAMPLE_PERIOD, 350.0, NULL);
+		print_results(noisy ? "pid (est., noisy)" : "pid (estimator)", est);
+		printf("%-22s %.0f%% of the periods had a reading, ETA at 5s was %us (%.0fs)\n",
+			   "", (100.0 * sim_readings) / sim_periods, sim_eta, est.heatup - 5.0);
+		printf("%-22s %.0f samples/s, %u per reading at 44s\n", "",
+			   sim_samples / 70.0, 1U << sim_steady_order);
+		printf("%-22s sample noise %.2f counts (%.2f), reading noise %.2f counts\n", "",
+			   sense_noise() / 64.0, sim_noise, sqrt(sense_variance() / 256.0) / 4);
+	}
+	sim_noise = 0.5;
+
+	// Switching spikes getting into the readings.
+	sim_spikes = 0.002;
+	print_results("pid (spikes)",
+				  run(iron, control_firmware, SAMPLE_PERIOD, 350.0, NULL));
+	printf("%-22s readings moved %.1fC peak to peak, %.1fC on the screen\n", "",
+		   fine_to_celsius(sim_raw_max - sim_raw_min),
+		   fine_to_celsius(sim_shown_max - sim_shown_min));
+	sim_spikes = 0;
+
+	// Let the autotune find its own gains.
+	SettingsData gains = settings;
+	double took = autotune(iron, 350.0);
+	if (took > 0) {
+		print_results("pid (autotuned)",
+					  run(iron, control_pid_ff, SAMPLE_PERIOD, 350.0, NULL));
+		printf("\nAutotune took %.1fs: Kp=%u Ki=%u Kd=%u\n", took,
+			   settings.pid_kp, settings.pid_ki, settings.pid_kd);
+	} else {
+		printf("\nAutotune failed.\n");
+	}
+	settings = gains;
+
+	// A brick that can only take 30W, with and without the boost at first.
+	printf("\nHeating up to 350C on a %dW brick, soldering the joint at %.0fs.\n\n",
+		   LIMITED_WATTS, LIMITED_LOAD_START);
+	print_results("pid (30W)", run_limited(iron, false));
+	print_results("pid (30W, boost)", run_limited(iron, true));
+
+	// The same controller on weaker supplies, with and without the feed-forward.
+	// A lower setpoint is used since this iron can't even hold 350C below ~20V.
+	printf("\nHeating up to %.0fC on different supplies, soldering the joint at %.0fs.\n\n",
+		   SUPPLY_SETPOINT, SUPPLY_LOAD_START);
+	for (int vin = 24; vin >= 12; vin -= 3) {
+		char name[32];
+		Iron weak = iron;
+		weak.vin = vin;
+
+		sprintf(name, "pid (%dV)", vin);
+		print_results(name, run(weak, control_pid, SAMPLE_PERIOD,
+								SUPPLY_SETPOINT, SUPPLY_LOAD_START, NULL));
+		sprintf(name, "pid (%dV, feed-fwd)", vin);
+		print_results(name, run(weak, control_pid_ff, SAMPLE_PERIOD,
+								SUPPLY_SETPOINT, SUPPLY_LOAD_START, NULL));
+
+		if (!can_hold(weak, SUPPLY_SETPOINT)) {
+			printf("%-22s can't hold %.0fC, %.1fW short\n", "", SUPPLY_SETPOINT,
+				   -power_margin(weak, SUPPLY_SETPOINT));
+		}
+	}
+
+	// Traces for plotting.
+	if (argc == 2) {
+		FILE *trace = fopen(argv[1], "w");
+		if (trace != NULL) {
+			run(iron, control_pid_ff, SAMPLE_PERIOD, 350.0, trace);
+			fclose(trace);
+		}
+	}
+
+	return 0;
+}
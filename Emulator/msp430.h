@@ -0,0 +1,10 @@
+/**
+ *    Filename: msp430.h
+ * Description: Host stand-in for the generic MSP430 device header.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#include "msp430g2553.h"
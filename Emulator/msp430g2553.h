@@ -0,0 +1,188 @@
+/**
+ *    Filename: msp430g2553.h
+ * Description: Host stand-in for the MSP430G2553 device header.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#ifndef EMU_MSP430G2553_H_
+#define EMU_MSP430G2553_H_
+
+#include <stdint.h>
+
+// Port register that tells the emulated hardware whenever it changes.
+class Port {
+public:
+	Port(void (*hook)(uint8_t value)) : value(0), hook(hook) {}
+
+	operator uint8_t() const { return value; }
+	Port& operator=(const unsigned int v) { set(v); return *this; }
+	Port& operator|=(const unsigned int v) { set(value | v); return *this; }
+	Port& operator&=(const unsigned int v) { set(value & v); return *this; }
+	Port& operator^=(const unsigned int v) { set(value ^ v); return *this; }
+
+private:
+	uint8_t value;
+	void (*hook)(uint8_t value);
+
+	void set(const unsigned int v);
+};
+
+// Emulated CPU state.
+extern uint64_t emu_cycles;
+extern unsigned long emu_sleeps;
+extern unsigned int emu_sr;
+void emu_sleep(const unsigned int bits);
+
+// Bits.
+#define BIT0 0x0001
+#define BIT1 0x0002
+#define BIT2 0x0004
+#define BIT3 0x0008
+#define BIT4 0x0010
+#define BIT5 0x0020
+#define BIT6 0x0040
+#define BIT7 0x0080
+
+// Status register.
+#define GIE    0x0008
+#define CPUOFF 0x0010
+#define OSCOFF 0x0020
+#define SCG0   0x0040
+#define SCG1   0x0080
+#define LPM0_bits (CPUOFF)
+#define LPM3_bits (SCG1 + SCG0 + CPUOFF)
+#define LPM4_bits (SCG1 + SCG0 + OSCOFF + CPUOFF)
+
+// Registers.
+#define EMU_REG8(name)  extern volatile unsigned char name;
+#define EMU_REG16(name) extern volatile unsigned int name;
+
+EMU_REG8(P1OUT) EMU_REG8(P1DIR) EMU_REG8(P1SEL) EMU_REG8(P1SEL2) EMU_REG8(P1IN)
+EMU_REG8(P1IE) EMU_REG8(P1IES) EMU_REG8(P1IFG) EMU_REG8(P1REN)
+EMU_REG8(P2DIR) EMU_REG8(P2SEL) EMU_REG8(P2SEL2) EMU_REG8(P2IN)
+EMU_REG8(P2IE) EMU_REG8(P2IES) EMU_REG8(P2IFG) EMU_REG8(P2REN)
+extern Port P2OUT;
+
+EMU_REG8(BCSCTL1) EMU_REG8(BCSCTL2) EMU_REG8(BCSCTL3) EMU_REG8(DCOCTL)
+EMU_REG8(CALBC1_16MHZ) EMU_REG8(CALDCO_16MHZ)
+EMU_REG16(WDTCTL)
+
+EMU_REG16(ADC10CTL0) EMU_REG16(ADC10CTL1) EMU_REG8(ADC10AE0)
+EMU_REG8(ADC10DTC0) EMU_REG8(ADC10DTC1) EMU_REG16(ADC10SA) EMU_REG16(ADC10MEM)
+
+EMU_REG16(TA0CTL) EMU_REG16(TA0R) EMU_REG16(TA0IV)
+EMU_REG16(TA0CCTL0) EMU_REG16(TA0CCTL1) EMU_REG16(TA0CCTL2)
+EMU_REG16(TA0CCR0) EMU_REG16(TA0CCR1) EMU_REG16(TA0CCR2)
+EMU_REG16(TA1CTL) EMU_REG16(TA1R) EMU_REG16(TA1IV)
+EMU_REG16(TA1CCTL0) EMU_REG16(TA1CCTL1) EMU_REG16(TA1CCTL2)
+EMU_REG16(TA1CCR0) EMU_REG16(TA1CCR1) EMU_REG16(TA1CCR2)
+
+EMU_REG8(UCB0CTL0) EMU_REG8(UCB0CTL1) EMU_REG8(UCB0BR0) EMU_REG8(UCB0BR1)
+EMU_REG16(UCB0I2CSA) EMU_REG8(UCB0I2CIE) EMU_REG8(UCB0STAT)
+EMU_REG8(UCB0TXBUF) EMU_REG8(UCB0RXBUF) EMU_REG8(IFG2) EMU_REG8(IE2)
+
+// Watchdog.
+#define WDTPW   0x5A00
+#define WDTHOLD 0x0080
+
+// Basic clock.
+#define DIVS_0 0x00
+#define DIVS_3 0x06
+
+// ADC10.
+#define ADC10SC    0x0001
+#define ENC        0x0002
+#define ADC10IFG   0x0004
+#define ADC10IE    0x0008
+#define ADC10ON    0x0010
+#define REFON      0x0020
+#define MSC        0x0080
+#define ADC10SHT_0 0x0000
+#define ADC10SHT_1 0x0800
+#define ADC10SHT_2 0x1000
+#define ADC10SHT_3 0x1800
+#define SREF_0     0x0000
+#define ADC10BUSY  0x0001
+#define BUSY       ADC10BUSY
+#define CONSEQ_0   0x0000
+#define CONSEQ_1   0x0002
+#define CONSEQ_2   0x0004
+#define CONSEQ_3   0x0006
+#define ADC10SSEL_0 0x0000
+#define ADC10SSEL_3 0x0018
+#define ADC10DIV_0 0x0000
+#define ADC10DIV_3 0x0060
+#define ADC10DIV_7 0x00E0
+#define SHS_0      0x0000
+#define SHS_1      0x0400
+#define SHS_2      0x0800
+#define SHS_3      0x0C00
+#define INCH_0     0x0000
+#define INCH_1     0x1000
+#define INCH_2     0x2000
+#define INCH_3     0x3000
+#define ADC10FETCH 0x0001
+#define ADC10B1    0x0002
+#define ADC10CT    0x0004
+#define ADC10TB    0x0008
+
+// Timer_A.
+#define TAIFG    0x0001
+#define TAIE     0x0002
+#define TACLR    0x0004
+#define MC_0     0x0000
+#define MC_1     0x0010
+#define MC_2     0x0020
+#define MC_3     0x0030
+#define ID_0     0x0000
+#define ID_3     0x00C0
+#define TASSEL_1 0x0100
+#define TASSEL_2 0x0200
+#define CCIFG    0x0001
+#define CCIE     0x0010
+#define OUTMOD_0 0x0000
+#define OUTMOD_3 0x0060
+#define OUTMOD_7 0x00E0
+#define TA0IV_TACCR1 0x0002
+#define TA0IV_TACCR2 0x0004
+#define TA0IV_TAIFG  0x000A
+#define TA1IV_TACCR1 0x0002
+#define TA1IV_TACCR2 0x0004
+#define TA1IV_TAIFG  0x000A
+
+// USCI_B0.
+#define UCSYNC    0x01
+#define UCMODE_3  0x06
+#define UCMST     0x08
+#define UCSWRST   0x01
+#define UCTXSTT   0x02
+#define UCTXSTP   0x04
+#define UCTXNACK  0x08
+#define UCTR      0x10
+#define UCSSEL_2  0x80
+#define UCNACKIE  0x08
+#define UCNACKIFG 0x08
+#define UCB0RXIE  0x04
+#define UCB0TXIE  0x08
+#define UCB0RXIFG 0x04
+#define UCB0TXIFG 0x08
+
+// Compiler intrinsics.
+#define __interrupt
+#define __no_operation()              ((void)0)
+#define __delay_cycles(n)             (emu_cycles += (n))
+#define __enable_interrupt()          (emu_sr |= GIE)
+#define __disable_interrupt()         (emu_sr &= ~GIE)
+#define __get_interrupt_state()       (emu_sr & GIE)
+#define __set_interrupt_state(s)      (emu_sr = (emu_sr & ~GIE) | ((s) & GIE))
+#define __get_SR_register()           (emu_sr)
+#define __bis_SR_register(bits)       emu_sleep(bits)
+#define __bic_SR_register(bits)       (emu_sr &= ~(bits))
+#define __bis_SR_register_on_exit(bits) ((void)(bits))
+#define __bic_SR_register_on_exit(bits) ((void)(bits))
+#define __even_in_range(x, y)         (x)
+
+#endif /* EMU_MSP430G2553_H_ */
@@ -0,0 +1,213 @@
+/**
+ *    Filename: pcd8544.cpp
+ * Description: Pin-level model of the PCD8544 (Nokia 5110) LCD controller.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#include "msp430g2553.h"
+#include "pcd8544.h"
+#include <stdio.h>
+#include <string.h>
+
+// Display Control bits (D, E).
+#define DISPLAY_BLANK    0b000
+#define DISPLAY_NORMAL   0b100
+#define DISPLAY_ALLON    0b001
+#define DISPLAY_INVERTED 0b101
+
+/**
+ * Creates a controller fresh out of reset.
+ */
+Pcd8544::Pcd8544() {
+	memset(ram, 0, sizeof(ram));
+	last_pins = PCD8544_SCE;
+	reset();
+	reset_stats();
+}
+
+/**
+ * Resets the controller state. The display RAM is left alone, just like the
+ * real thing.
+ */
+void Pcd8544::reset() {
+	x = 0;
+	y = 0;
+	extended = false;
+	vertical = false;
+	powerdown = true;
+	display_mode = DISPLAY_BLANK;
+	shift = 0;
+	bits = 0;
+}
+
+/**
+ * Clears the bus traffic counters.
+ */
+void Pcd8544::reset_stats() {
+	memset(&stats, 0, sizeof(stats));
+}
+
+/**
+ * Updates the state of the interface pins. (P2OUT)
+ *
+ * @param value New state of the pins.
+ */
+void Pcd8544::pins(const uint8_t value) {
+	uint8_t changed = last_pins ^ value;
+	last_pins = value;
+	stats.pin_writes++;
+
+	// Reset is active low.
+	if (!(value & PCD8544_RST)) {
+		reset();
+		return;
+	}
+
+	// SCE going low starts a packet.
+	if ((changed & PCD8544_SCE) && !(value & PCD8544_SCE)) {
+		bits = 0;
+		stats.packets++;
+	}
+
+	// Data is sampled on the rising edge of SCLK while SCE is low.
+	if ((changed & PCD8544_SCLK) && (value & PCD8544_SCLK) &&
+			!(value & PCD8544_SCE)) {
+		shift = (shift << 1) | ((value & PCD8544_MOSI) ? 1 : 0);
+
+		// D/C is sampled with the last bit.
+		if (++bits == 8) {
+			receive(shift, value & PCD8544_D_C);
+			bits = 0;
+		}
+	}
+}
+
+/**
+ * Handles a byte received by the controller.
+ *
+ * @param b The byte.
+ * @param data Is it display data?
+ */
+void Pcd8544::receive(const uint8_t b, const bool data) {
+	if (data) {
+		stats.data_bytes++;
+		ram[y][x] = b;
+		advance();
+		return;
+	}
+
+	stats.command_bytes++;
+	if ((b & 0b11111000) == 0b00100000) {
+		// Function set.
+		powerdown = b & 0b100;
+		vertical = b & 0b010;
+		extended = b & 0b001;
+	} else if (!extended) {
+		if (b & 0b10000000) {
+			stats.address_commands++;
+			if ((b & 0b01111111) < PCD8544_COLUMNS) {
+				x = b & 0b01111111;
+			} else {
+				stats.invalid_addresses++;
+			}
+		} else if (b & 0b01000000) {
+			stats.address_commands++;
+			if ((b & 0b00000111) < PCD8544_BANKS) {
+				y = b & 0b00000111;
+			} else {
+				stats.invalid_addresses++;
+			}
+		} else if ((b & 0b11111000) == 0b00001000) {
+			display_mode = ((b & 0b100) ? 0b100 : 0) | (b & 0b001);
+		}
+	}
+
+	// Bias, Vop and temperature coefficient don't change what we show.
+}
+
+/**
+ * Moves the address counters after a data write.
+ */
+void Pcd8544::advance() {
+	if (vertical) {
+		if (++y >= PCD8544_BANKS) {
+			y = 0;
+			if (++x >= PCD8544_COLUMNS) {
+				x = 0;
+			}
+		}
+	} else {
+		if (++x >= PCD8544_COLUMNS) {
+			x = 0;
+			if (++y >= PCD8544_BANKS) {
+				y = 0;
+			}
+		}
+	}
+}
+
+/**
+ * Gets the state of a pixel as it'd be seen on the glass.
+ *
+ * @param x Pixel column.
+ * @param y Pixel row.
+ * @return TRUE if the pixel is dark.
+ */
+bool Pcd8544::pixel(const unsigned int x, const unsigned int y) const {
+	bool on = ram[y / 8][x] & (1 << (y % 8));
+
+	if (powerdown) {
+		return false;
+	}
+
+	switch (display_mode) {
+	case DISPLAY_ALLON:
+		return true;
+	case DISPLAY_INVERTED:
+		return !on;
+	case DISPLAY_NORMAL:
+		return on;
+	}
+
+	return false;
+}
+
+/**
+ * Writes what's on the display to a PGM file.
+ *
+ * @param filename Output file.
+ * @param rotated Is the display mounted upside down?
+ * @param scale Size of each pixel in the image.
+ * @return TRUE if the file was written.
+ */
+bool Pcd8544::write_pgm(const char *filename, const bool rotated,
+						const unsigned int scale) const {
+	const unsigned int width = PCD8544_COLUMNS;
+	const unsigned int height = PCD8544_BANKS * 8;
+	FILE *fh = fopen(filename, "wb");
+
+	if (fh == NULL) {
+		return false;
+	}
+
+	fprintf(fh, "P5\n%u %u\n255\n", width * scale, height * scale);
+	for (unsigned int py = 0; py < height * scale; py++) {
+		for (unsigned int px = 0; px < width * scale; px++) {
+			unsigned int x = px / scale;
+			unsigned int y = py / scale;
+
+			if (rotated) {
+				x = width - 1 - x;
+				y = height - 1 - y;
+			}
+
+			fputc(pixel(x, y) ? 0x20 : 0xC8, fh);
+		}
+	}
+
+	fclose(fh);
+	return true;
+}
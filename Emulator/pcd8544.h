@@ -0,0 +1,70 @@
+/**
+ *    Filename: pcd8544.h
+ * Description: Pin-level model of the PCD8544 (Nokia 5110) LCD controller.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#ifndef EMU_PCD8544_H_
+#define EMU_PCD8544_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Display RAM size.
+#define PCD8544_COLUMNS 84
+#define PCD8544_BANKS   6
+
+// Port 2 pins, same as lcd.c.
+#define PCD8544_SCLK BIT0
+#define PCD8544_MOSI BIT1
+#define PCD8544_D_C  BIT2
+#define PCD8544_SCE  BIT3
+#define PCD8544_RST  BIT7
+
+// Bus traffic counters.
+typedef struct {
+	unsigned long data_bytes;
+	unsigned long command_bytes;
+	unsigned long address_commands;
+	unsigned long packets;
+	unsigned long pin_writes;
+	unsigned long invalid_addresses;
+} Pcd8544Stats;
+
+class Pcd8544 {
+public:
+	uint8_t ram[PCD8544_BANKS][PCD8544_COLUMNS];
+	Pcd8544Stats stats;
+
+	Pcd8544();
+
+	void reset();
+	void reset_stats();
+	void pins(const uint8_t value);
+
+	bool pixel(const unsigned int x, const unsigned int y) const;
+	bool write_pgm(const char *filename, const bool rotated,
+				   const unsigned int scale) const;
+
+private:
+	// Address counters and instruction set.
+	uint8_t x;
+	uint8_t y;
+	bool extended;
+	bool vertical;
+	bool powerdown;
+	uint8_t display_mode;
+
+	// Serial interface.
+	uint8_t last_pins;
+	uint8_t shift;
+	uint8_t bits;
+
+	void receive(const uint8_t b, const bool data);
+	void advance();
+};
+
+#endif /* EMU_PCD8544_H_ */
@@ -0,0 +1,158 @@
+/**
+ *    Filename: autotune.c
+ * Description: Relay (Astrom-Hagglund) autotuning of the PID gains.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#include "autotune.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "settings.h"
+#include "pid.h"
+
+// Global variables.
+volatile uint8_t autotune_state = AUTOTUNE_FAILED;
+volatile uint8_t autotune_cycle = 0;
+
+// Experiment state.
+unsigned int at_setpoint = 0;
+unsigned int at_samples = 0;
+unsigned int at_last_rise = 0;
+unsigned int at_peak_max = 0;
+unsigned int at_peak_min = 0;
+unsigned long at_period_sum = 0;
+unsigned long at_swing_sum = 0;
+unsigned int at_max = 0;
+bool at_relay_on = true;
+
+// Private functions.
+unsigned int autotune_gain(const float gain);
+
+/**
+ * Starts a new relay experiment.
+ *
+ * @param setpoint Temperature to oscillate around in ADC counts.
+ */
+void autotune_start(const unsigned int setpoint) {
+	at_setpoint = setpoint;
+	at_samples = 0;
+	at_last_rise = 0;
+	at_peak_max = 0;
+	at_peak_min = 0xFFFF;
+	at_period_sum = 0;
+	at_swing_sum = 0;
+	at_relay_on = true;
+
+	autotune_cycle = 0;
+	autotune_state = AUTOTUNE_RUNNING;
+}
+
+/**
+ * Runs the relay for a new sample. Once all the cycles are in the heater is
+ * turned off and the state goes to AUTOTUNE_MEASURED, autotune_finish() has to
+ * be called outside of the control tick to work out the gains.
+ *
+ * @param measured Measured temperature in ADC counts.
+ * @param max Maximum duty cycle that can be delivered.
+ * @return Duty cycle for the heater.
+ */
+unsigned int autotune_update(const unsigned int measured, const unsigned int max) {
+	if (autotune_state != AUTOTUNE_RUNNING) {
+		return 0;
+	}
+
+	// Give up if it's not oscillating.
+	if (++at_samples >= AUTOTUNE_TIMEOUT) {
+		autotune_state = AUTOTUNE_FAILED;
+		return 0;
+	}
+
+	// Keep track of the peaks of this cycle.
+	if (measured > at_peak_max) {
+		at_peak_max = measured;
+	}
+	if (measured < at_peak_min) {
+		at_peak_min = measured;
+	}
+
+	// Relay with hysteresis.
+	if (at_relay_on && (measured > (at_setpoint + AUTOTUNE_HYSTERESIS))) {
+		at_relay_on = false;
+	} else if (!at_relay_on && (measured < (at_setpoint - AUTOTUNE_HYSTERESIS))) {
+		at_relay_on = true;
+
+		// Every time the relay turns on again a whole cycle has gone by.
+		if (autotune_cycle > AUTOTUNE_SKIP_CYCLES) {
+			at_period_sum += at_samples - at_last_rise;
+			at_swing_sum += at_peak_max - at_peak_min;
+		}
+
+		at_last_rise = at_samples;
+		at_peak_max = measured;
+		at_peak_min = measured;
+
+		if (++autotune_cycle > (AUTOTUNE_SKIP_CYCLES + AUTOTUNE_CYCLES)) {
+			at_max = max;
+			autotune_state = AUTOTUNE_MEASURED;
+			return 0;
+		}
+	}
+
+	if (at_relay_on) {
+		return max;
+	}
+
+	return 0;
+}
+
+/**
+ * Calculates the PID gains from the measured oscillation. It's all floating
+ * point, so it should be done from the main loop and not the control tick.
+ */
+void autotune_finish() {
+	// Ultimate gain (PWM counts per ADC count) and period (samples).
+	float swing = (float)at_swing_sum / AUTOTUNE_CYCLES;
+	float tu = (float)at_period_sum / AUTOTUNE_CYCLES;
+	float ku;
+
+	if (swing < 1) {
+		autotune_state = AUTOTUNE_FAILED;
+		return;
+	}
+
+	// Relay of amplitude max / 2, oscillation of amplitude swing / 2.
+	ku = (4.0 * (at_max / 2.0)) / (3.14159 * (swing / 2.0));
+
+	// Tyreus-Luyben rules, which are a lot less aggressive than the
+	// Ziegler-Nichols ones and don't overshoot on a laggy heater.
+	float kp = ku / 2.2;
+	float ti = tu * 2.2;
+	float td = tu / 6.3;
+
+	settings.pid_kp = autotune_gain(kp * (float)(1UL << PID_KP_SHIFT));
+	settings.pid_ki = autotune_gain((kp / ti) * (float)(1UL << PID_KI_SHIFT));
+	settings.pid_kd = autotune_gain((kp * td) * (float)(1UL << PID_KD_SHIFT));
+
+	autotune_state = AUTOTUNE_DONE;
+}
+
+/**
+ * Converts a gain into the fixed-point format used in the settings.
+ *
+ * @param gain Gain, already scaled.
+ * @return Gain saturated to fit the settings.
+ */
+unsigned int autotune_gain(const float gain) {
+	// Stay clear of 0xFFFF, which would read back as a blank EEPROM.
+	if (gain >= 32767.0) {
+		return 0x7FFF;
+	} else if (gain < 0) {
+		return 0;
+	}
+
+	return (unsigned int)gain;
+}
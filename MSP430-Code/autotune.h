@@ -0,0 +1,35 @@
+/**
+ *    Filename: autotune.h
+ * Description: Relay (Astrom-Hagglund) autotuning of the PID gains.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#ifndef AUTOTUNE_H_
+#define AUTOTUNE_H_
+
+#include <stdint.h>
+#include "timer.h"
+
+// States.
+#define AUTOTUNE_RUNNING  0
+#define AUTOTUNE_DONE     1
+#define AUTOTUNE_FAILED   2
+#define AUTOTUNE_MEASURED 3  // Waiting for autotune_finish().
+
+// Experiment parameters.
+#define AUTOTUNE_HYSTERESIS  2      // ADC counts around the setpoint.
+#define AUTOTUNE_SKIP_CYCLES 2      // Cycles ignored while it settles.
+#define AUTOTUNE_CYCLES      4      // Cycles measured.
+#define AUTOTUNE_TIMEOUT     (120U * CONTROL_RATE_HZ)  // 2 minutes.
+
+extern volatile uint8_t autotune_state;
+extern volatile uint8_t autotune_cycle;
+
+void autotune_start(const unsigned int setpoint);
+unsigned int autotune_update(const unsigned int measured, const unsigned int max);
+void autotune_finish();
+
+#endif /* AUTOTUNE_H_ */
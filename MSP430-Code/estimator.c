@@ -0,0 +1,143 @@
+/**
+ *    Filename: estimator.c
+ * Description: Thermal model of the iron that keeps track of the temperature
+ *              in between sensor readings.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#include "estimator.h"
+#include <msp430g2553.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Estimated temperature. (ADC counts in Q16)
+long est_temp = 0;
+
+// Heat flow the model doesn't know about. (ADC counts per period in Q16)
+long est_load = 0;
+
+// Control periods since the last reading.
+unsigned int est_age = 0;
+
+// Was the last reading close to what the model expected?
+bool est_trusted = false;
+
+// Private functions.
+long estimator_step(const long temp, const long load, const unsigned int power);
+
+/**
+ * Starts over from a reading, should be done every time the heater was off.
+ *
+ * @param measured Current reading of the sensor in fine counts.
+ */
+void estimator_reset(const unsigned int measured) {
+	est_temp = (long)measured << (16 - SENSE_FRAC_BITS);
+	est_load = 0;
+	est_age = 0;
+	est_trusted = false;
+}
+
+/**
+ * Predicts the temperature at the end of a control period.
+ *
+ * @param power Power that was sent to the heater during the period.
+ */
+void estimator_update(const unsigned int power) {
+	est_temp += estimator_step(est_temp, est_load, power);
+
+	if (est_age < EST_MAX_AGE) {
+		est_age++;
+	}
+}
+
+/**
+ * Corrects the estimate with a new reading.
+ *
+ * @param measured Measured temperature in fine counts.
+ */
+void estimator_correct(const unsigned int measured) {
+	long residual = ((long)measured << (16 - SENSE_FRAC_BITS)) - est_temp;
+
+	est_temp += residual >> EST_L_TEMP;
+	est_load += residual >> EST_L_LOAD;
+	est_age = 0;
+
+	// A load coming on or a bad model shows up as a big residual.
+	est_trusted = (residual < ((long)EST_TRUST << 16)) &&
+		(residual > -((long)EST_TRUST << 16));
+}
+
+/**
+ * Checks if the heater has to make room for a reading in the next period,
+ * either because it's been a while or because the model is off.
+ *
+ * @return TRUE if a reading is needed.
+ */
+bool estimator_needs_reading() {
+	return !est_trusted || (est_age >= EST_MAX_AGE);
+}
+
+/**
+ * Gets the estimated temperature.
+ *
+ * @return Temperature in fine counts.
+ */
+unsigned int estimator_temp() {
+	if (est_temp < 0) {
+		return 0;
+	}
+
+	return (unsigned int)(est_temp >> (16 - SENSE_FRAC_BITS));
+}
+
+/**
+ * Predicts how long it'll take to get to the setpoint. Safe to call from
+ * outside the control loop.
+ *
+ * @param setpoint Target temperature in fine counts.
+ * @param power Power that'll be sent to the heater until it gets there.
+ * @return Time in seconds, 0 if it's already there or ESTIMATOR_NEVER if it
+ *         won't get there with this power.
+ */
+unsigned int estimator_eta(const unsigned int setpoint, const unsigned int power) {
+	long target = (long)(setpoint - SENSE_FINE(EST_ETA_BAND)) << (16 - SENSE_FRAC_BITS);
+	unsigned int steps = 0;
+	long temp;
+	long load;
+
+	// Grab a copy of the state, it's updated by the control loop.
+	unsigned int state = __get_interrupt_state();
+	__disable_interrupt();
+	temp = est_temp;
+	load = est_load;
+	__set_interrupt_state(state);
+
+	// Roll the model forward in big steps until it gets there.
+	while (temp < target) {
+		if (++steps > ((EST_ETA_MAX_S * 1000UL) / EST_ETA_STEP_MS)) {
+			return ESTIMATOR_NEVER;
+		}
+
+		temp += estimator_step(temp, load, power) * (EST_ETA_STEP_MS / CONTROL_PERIOD_MS);
+	}
+
+	return (unsigned int)(((unsigned long)steps * EST_ETA_STEP_MS + 999) / 1000);
+}
+
+/**
+ * Change of temperature in a control period according to the model.
+ *
+ * @param temp Temperature. (ADC counts in Q16)
+ * @param load Unmodelled heat flow. (ADC counts per period in Q16)
+ * @param power Power sent to the heater.
+ * @return Temperature change. (ADC counts in Q16)
+ */
+long estimator_step(const long temp, const long load, const unsigned int power) {
+	long heat = ((long)EST_HEAT * power) >> 8;
+	long cool = ((long)EST_COOL * ((temp - ((long)EST_AMBIENT << 16)) >> 8)) >> 16;
+
+	return heat - cool + load;
+}
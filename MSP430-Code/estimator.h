@@ -0,0 +1,54 @@
+/**
+ *    Filename: estimator.h
+ * Description: Thermal model of the iron that keeps track of the temperature
+ *              in between sensor readings.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#ifndef ESTIMATOR_H_
+#define ESTIMATOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "timer.h"
+#include "heater.h"
+#include "settings.h"
+
+// First order model of a Hakko 907. (heating up to where the power takes it)
+#define EST_GAIN  ((640UL * 500) / PWM_PERIOD)  // Rise per unit of power. (ADC counts in Q8)
+#define EST_TAU_S 54                            // Time constant. (seconds)
+
+// Where a cold iron sits, 25C with the default calibration. (ADC counts)
+#define EST_AMBIENT (CAL_LOW_TEMP_ADC - ((245L * (CAL_HIGH_TEMP_ADC - CAL_LOW_TEMP_ADC)) / 145))
+
+// Model coefficients per control period. (Q24)
+#define EST_COOL ((1UL << 24) * CONTROL_PERIOD_MS / (1000UL * EST_TAU_S))
+#define EST_HEAT ((EST_COOL * EST_GAIN) >> 8)
+
+// Observer gains. (correction of 2^-n of the residual per reading)
+#define EST_L_TEMP 2  // Temperature.
+#define EST_L_LOAD 8  // Unmodelled heat flow, like a joint being soldered.
+
+// Readings have to keep coming in this often, and the model is only trusted
+// while it's within this many ADC counts of them.
+#define EST_MAX_AGE_MS 16
+#define EST_MAX_AGE    (EST_MAX_AGE_MS / CONTROL_PERIOD_MS)
+#define EST_TRUST      3
+
+// Time to the setpoint.
+#define EST_ETA_BAND    5    // ADC counts from the setpoint to be considered there.
+#define EST_ETA_STEP_MS 500  // Resolution of the prediction.
+#define EST_ETA_MAX_S   120  // Furthest it looks ahead.
+#define ESTIMATOR_NEVER 0xFFFF
+
+void estimator_reset(const unsigned int measured);
+void estimator_update(const unsigned int power);
+void estimator_correct(const unsigned int measured);
+bool estimator_needs_reading();
+unsigned int estimator_temp();
+unsigned int estimator_eta(const unsigned int setpoint, const unsigned int power);
+
+#endif /* ESTIMATOR_H_ */
@@ -0,0 +1,142 @@
+/**
+ *    Filename: format.c
+ * Description: Tiny number formatting helpers, so we don't need printf.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#include "format.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "lcd.h"
+
+// Digits are found by subtraction, since we don't have a hardware divider.
+static const unsigned int powers_of_ten[] = { 10000, 1000, 100, 10, 1 };
+
+/**
+ * Formats a integer into a string, right aligned.
+ *
+ * @param buf Buffer with space for at least FORMAT_MAX_WIDTH + 1 characters.
+ * @param value Integer value.
+ * @param width Minimum width of the string, padded on the left.
+ * @param pad Padding character (goes before the sign).
+ * @return Length of the string.
+ */
+uint8_t format_int(char *buf, const int value, const uint8_t width,
+				   const char pad) {
+	char digits[7];
+	uint8_t len = 0;
+	uint8_t pos = 0;
+	unsigned int uval = value;
+	bool started = false;
+
+	// Take care of the sign.
+	if (value < 0) {
+		digits[len++] = '-';
+		uval = -value;
+	}
+
+	// Get the digits without the leading zeros.
+	for (uint8_t i = 0; i < 5; i++) {
+		char digit = '0';
+
+		while (uval >= powers_of_ten[i]) {
+			uval -= powers_of_ten[i];
+			digit++;
+		}
+
+		if (started || (digit != '0') || (i == 4)) {
+			digits[len++] = digit;
+			started = true;
+		}
+	}
+
+	// Pad and copy the digits.
+	while ((pos + len < width) && (pos < FORMAT_MAX_WIDTH - len)) {
+		buf[pos++] = pad;
+	}
+
+	for (uint8_t i = 0; i < len; i++) {
+		buf[pos++] = digits[i];
+	}
+
+	buf[pos] = '\0';
+	return pos;
+}
+
+/**
+ * Formats a positive fixed-point value with one decimal place into a string,
+ * right aligned.
+ *
+ * @param buf Buffer with space for at least FORMAT_MAX_WIDTH + 2 characters.
+ * @param tenths Value in tenths (123 is 12.3).
+ * @param width Minimum width of the string (point included).
+ * @param pad Padding character.
+ * @return Length of the string.
+ */
+uint8_t format_fixed(char *buf, const int tenths, const uint8_t width,
+					 const char pad) {
+	uint8_t len = format_int(buf, tenths, (width > 3) ? width - 1 : 2, pad);
+
+	// Make sure there's something before the point.
+	if ((buf[len - 2] < '0') || (buf[len - 2] > '9')) {
+		buf[len - 2] = '0';
+	}
+
+	// Insert the point before the last digit.
+	buf[len + 1] = '\0';
+	buf[len] = buf[len - 1];
+	buf[len - 1] = '.';
+
+	return len + 1;
+}
+
+/**
+ * Prints a integer on the screen.
+ *
+ * @param value Integer value.
+ */
+void print_int(const int value) {
+	print_int(value, 0, NORMAL);
+}
+
+/**
+ * Prints a integer on the screen, right aligned.
+ *
+ * @param value Integer value.
+ * @param width Minimum width, padded with spaces.
+ */
+void print_int(const int value, const uint8_t width) {
+	print_int(value, width, NORMAL);
+}
+
+/**
+ * Prints a integer on the screen, right aligned, with an effect.
+ *
+ * @param value Integer value.
+ * @param width Minimum width, padded with spaces.
+ * @param effect Font effect.
+ */
+void print_int(const int value, const uint8_t width, const uint8_t effect) {
+	char buf[FORMAT_MAX_WIDTH + 1];
+
+	format_int(buf, value, width, ' ');
+	lcd_print(buf, effect);
+}
+
+/**
+ * Prints a positive fixed-point value with one decimal place on the screen.
+ *
+ * @param tenths Value in tenths (123 is 12.3).
+ * @param width Minimum width (point included).
+ * @param pad Padding character.
+ */
+void print_fixed(const int tenths, const uint8_t width, const char pad) {
+	char buf[FORMAT_MAX_WIDTH + 2];
+
+	format_fixed(buf, tenths, width, pad);
+	lcd_print(buf);
+}
@@ -0,0 +1,30 @@
+/**
+ *    Filename: format.h
+ * Description: Tiny number formatting helpers, so we don't need printf.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#ifndef FORMAT_H_
+#define FORMAT_H_
+
+#include <stdint.h>
+
+// Widest number we can print (padding included).
+#define FORMAT_MAX_WIDTH 9
+
+// String formatting.
+uint8_t format_int(char *buf, const int value, const uint8_t width,
+				   const char pad);
+uint8_t format_fixed(char *buf, const int tenths, const uint8_t width,
+					 const char pad);
+
+// Printing to the LCD.
+void print_int(const int value);
+void print_int(const int value, const uint8_t width);
+void print_int(const int value, const uint8_t width, const uint8_t effect);
+void print_fixed(const int tenths, const uint8_t width, const char pad);
+
+#endif /* FORMAT_H_ */
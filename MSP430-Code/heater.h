@@ -0,0 +1,46 @@
+/**
+ *    Filename: heater.h
+ * Description: Heater PWM (Timer0_A) and sensor sampling timing.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#ifndef HEATER_H_
+#define HEATER_H_
+
+// Clock the PWM and the ADC run from.
+#define SMCLK_HZ 16000000UL
+
+// Heater PWM frequency, anything from 10kHz to 64kHz.
+#ifndef PWM_FREQ_HZ
+#define PWM_FREQ_HZ 32000UL
+#endif
+#define PWM_PERIOD (SMCLK_HZ / PWM_FREQ_HZ)  // SMCLK counts.
+
+// The heater has to be off for the sample and hold plus a bit for the sensor
+// to settle, and the conversion has to be done before the next period. On the
+// other end the gains are in PWM counts and the default Kp has to fit in the
+// settings.
+#if (PWM_PERIOD < 250) || (PWM_PERIOD > 1600)
+#error "The heater PWM has to be between 10kHz and 64kHz."
+#endif
+
+// ADC sampling. (one conversion triggered by TA0.2 at the end of every PWM period)
+#define ADC_CONVS        4   // Conversions in a sequence, A3 down to A0.
+#define ADC_BLOCK_ORDER  2   // Sequences in each DTC block. (2^n)
+#define ADC_BLOCK_SEQS   (1 << ADC_BLOCK_ORDER)
+#define ADC_SENSE_WINDOW 40  // Sample and hold time. (8 ADC10CLKs + sync)
+#define ADC_SENSE_SETTLE 48  // Time for the sensor to settle after the heater is off.
+#define ADC_TRIGGER      (PWM_PERIOD - ADC_SENSE_WINDOW)
+#define SENSE_MAX_DUTY   (ADC_TRIGGER - ADC_SENSE_SETTLE)
+
+// Oversampling. The samples in a reading are decimated to this many more bits
+// than the ADC has, which the noise on the sensor makes real, and the sensor
+// readings are carried around in these fine counts. (ADC counts in Q2)
+#define SENSE_FRAC_BITS    2
+#define SENSE_FINE(counts) ((counts) << SENSE_FRAC_BITS)
+#define SENSE_COARSE(fine) ((fine) >> SENSE_FRAC_BITS)
+
+#endif /* HEATER_H_ */
@@ -11,10 +11,10 @@
 #include <msp430g2553.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 // Helpers.
 #include "delay.h"
-#include "bitop.h"
 
 // Pins.
 #define SCLK BIT0  // P2.0
@@ -27,12 +27,50 @@
 #define LCDWIDTH  84
 #define LCDHEIGHT 48
 #define LCDAREA   LCDWIDTH * LCDHEIGHT
+#define LCDBANKS  (LCDHEIGHT / 8)
+
+// Puts a bit of a byte in MOSI and sends a clock pulse.
+#define LCD_SHIFT_BIT(b, bit) \
+	if ((b) & (bit)) { P2OUT |= MOSI; } else { P2OUT &= ~MOSI; } \
+	P2OUT |= SCLK; \
+	P2OUT &= ~SCLK
+
+// Output queue entries. Each one carries the byte, the D/C flag and the number
+// of times to send it. Glyph entries carry a character and its effect instead,
+// and the pump reads the columns straight from the font.
+#define QUEUE_DATA        0x0100
+#define QUEUE_COUNT_SHIFT 9
+#define QUEUE_COUNT_MASK  (0x3F << QUEUE_COUNT_SHIFT)
+#define QUEUE_COUNT(e)    ((((e) & QUEUE_COUNT_MASK) >> QUEUE_COUNT_SHIFT) + 1)
+#define QUEUE_RUN_MAX     64
+#define QUEUE_GLYPH       0x8000
+#define QUEUE_EFFECT(e)   (((e) >> QUEUE_COUNT_SHIFT) & 0x03)
+#define GLYPH_COLUMNS     (FONT_WIDTH + 1)
+
+// Output queue.
+volatile uint16_t lcd_queue[LCD_QUEUE_SIZE];
+volatile uint8_t queue_head = 0;
+volatile uint8_t queue_tail = 0;
+volatile bool lcd_waiting = false;
+volatile uint8_t lcd_queue_peak = 0;
+
+// Entry being sent by the interrupt.
+uint16_t pump_entry = 0;
+volatile uint8_t pump_remaining = 0;
 
 #ifdef ROTATION_ENABLE
 uint8_t pos_x = PCD8544_WIDTH;
 uint8_t pos_y = PCD8544_HEIGHT;
 #endif
 
+// Private functions.
+void lcd_enqueue(const uint16_t entry, unsigned int count);
+void lcd_pump();
+void lcd_wait(const uint8_t entries);
+inline void lcd_shift_byte(const uint8_t b);
+uint8_t lcd_glyph_column(const uint16_t entry, const uint8_t column);
+void lcd_put_glyph(const char c, uint8_t effect);
+
 /**
  *  Setup the pins for communication with the LCD driver.
  */
@@ -62,68 +100,235 @@ void lcd_init() {
 }
 
 /**
- *  Send a command to the LCD controller. (Simulating SPI)
+ *  Puts the controller in power-down mode and waits for the command to get
+ *  there. The display RAM is kept, but nothing is shown.
+ */
+void lcd_powerdown() {
+	lcd_command(PCD8544_FUNCTIONSET | PCD8544_POWERDOWN, 0);
+	lcd_flush();
+}
+
+/**
+ *  Wakes the controller up from power-down mode.
+ */
+void lcd_powerup() {
+	lcd_command(PCD8544_FUNCTIONSET, 0);
+}
+
+/**
+ *  Queues a byte to be sent to the LCD controller.
  *
  *  @param command A command to send.
  *  @param data Some data to be sent.
  */
 void lcd_command(const char command, const char data) {
-	// Combine both into one byte to be sent.
-	char dbyte = (command | data);
-
-	P2OUT &= ~SCLK;  // Put the clock line LOW to start.
-	P2OUT &= ~EN;    // Pull the EN pin LOW to start sending a packet.
-
-	// The packet must be most significant bit first, so we need to send the
-	// data from bits 7 to 0.
-	for (int i = 7; i >= 0; i--) {
-		// Check if it's time to set the Data pin and if it'll be needed.
-		if ((i == 0) & (command == 0)) {
-			P2OUT |= D_C;
+	if (command == 0) {
+		lcd_enqueue(QUEUE_DATA | (uint8_t)data, 1);
+	} else {
+		lcd_enqueue((uint8_t)(command | data), 1);
+	}
+}
+
+/**
+ *  Writes the same display data byte a bunch of times starting at the current
+ *  address.
+ *
+ *  @param data Display data byte.
+ *  @param len Number of times to write it.
+ */
+void lcd_fill(const uint8_t data, unsigned int len) {
+	lcd_enqueue(QUEUE_DATA | data, len);
+}
+
+/**
+ *  Puts an entry in the output queue, which gets sent to the controller in the
+ *  background by the Timer1_A CCR1 interrupt. If the queue is full this waits
+ *  for some space, or sends stuff itself if interrupts are disabled.
+ *
+ *  @param entry Queue entry without the count.
+ *  @param count Number of times the entry should be sent.
+ */
+void lcd_enqueue(const uint16_t entry, unsigned int count) {
+	while (count) {
+		unsigned int state = __get_interrupt_state();
+		__disable_interrupt();
+
+		// Try to make the last entry longer.
+		uint8_t last = (queue_head - 1) & (LCD_QUEUE_SIZE - 1);
+		if ((queue_head != queue_tail) && !(entry & QUEUE_GLYPH) &&
+				((lcd_queue[last] & ~QUEUE_COUNT_MASK) == entry) &&
+				(QUEUE_COUNT(lcd_queue[last]) < QUEUE_RUN_MAX)) {
+			lcd_queue[last] += (1 << QUEUE_COUNT_SHIFT);
+			count--;
+
+			__set_interrupt_state(state);
+			continue;
+		}
+
+		// Wait for some space.
+		if (((queue_head + 1) & (LCD_QUEUE_SIZE - 1)) == queue_tail) {
+			__set_interrupt_state(state);
+			lcd_wait(LCD_QUEUE_SIZE - 2);
+			continue;
+		}
+
+		// Add a new entry. Glyphs are always a single one.
+		uint8_t run = (count > QUEUE_RUN_MAX) ? QUEUE_RUN_MAX : count;
+		if (entry & QUEUE_GLYPH) {
+			lcd_queue[queue_head] = entry;
+			run = 1;
+		} else {
+			lcd_queue[queue_head] = entry | ((run - 1) << QUEUE_COUNT_SHIFT);
+		}
+		queue_head = (queue_head + 1) & (LCD_QUEUE_SIZE - 1);
+		count -= run;
+
+		// Keep track of how deep the queue gets.
+		uint8_t used = (queue_head - queue_tail) & (LCD_QUEUE_SIZE - 1);
+		if (used > lcd_queue_peak) {
+			lcd_queue_peak = used;
 		}
 
-		// Set MOSI according to bit.
-		byte_to_pin(dbyte, i, &P2OUT, MOSI);
+		lcd_flush_async();
+		__set_interrupt_state(state);
+	}
+}
 
-		// Send a clock pulse.
-		P2OUT |= SCLK;   // Set clock HIGH to send the bit.
-		P2OUT &= ~SCLK;  // Set the clock back to LOW and prepare for the next bit.
+/**
+ *  Starts sending whatever is in the output queue in the background and
+ *  returns right away.
+ */
+void lcd_flush_async() {
+	unsigned int state = __get_interrupt_state();
+	__disable_interrupt();
+
+	// Start pumping if we aren't already.
+	if (lcd_busy() && !(TA1CCTL1 & CCIE)) {
+		TA1CCR1 = TA1R + LCD_PUMP_COUNTS;
+		TA1CCTL1 = CCIE;
 	}
 
-	// Finish the packet and clean the mess.
-	P2OUT |= EN;
-	P2OUT &= ~(SCLK + MOSI + D_C);
+	__set_interrupt_state(state);
 }
 
 /**
- *  Prints a character on the screen.
- *
- *  @param c A character.
+ *  Sends the next few bytes of the output queue to the controller. EN is kept
+ *  LOW for as long as there's something in the queue, so a whole burst of
+ *  entries goes out as a single packet.
  */
-void lcd_putc(const char c) {
-#ifdef ROTATION_ENABLE
-	// Move the cursor 6 columns to make space for the letter.
-	pos_x -= 6;
-	lcd_command(PCD8544_SETXADDR, pos_x);
+void lcd_pump() {
+	uint8_t budget = LCD_PUMP_BYTES;
+
+	while (budget) {
+		// Grab the next entry.
+		if (pump_remaining == 0) {
+			if (queue_head == queue_tail) {
+				break;
+			}
+
+			pump_entry = lcd_queue[queue_tail];
+			if (pump_entry & QUEUE_GLYPH) {
+				pump_remaining = GLYPH_COLUMNS;
+			} else {
+				pump_remaining = QUEUE_COUNT(pump_entry);
+			}
+			queue_tail = (queue_tail + 1) & (LCD_QUEUE_SIZE - 1);
+
+			// The D/C pin is only sampled on the last bit, so set it up front.
+			if (pump_entry & QUEUE_DATA) {
+				P2OUT |= D_C;
+			} else {
+				P2OUT &= ~D_C;
+			}
+		}
 
-	// Send a blank column to separate from the next character.
-	lcd_command(0, 0);
+		// Pull the EN pin LOW to start sending the packet if it isn't already.
+		if (P2OUT & EN) {
+			P2OUT &= ~SCLK;
+			P2OUT &= ~EN;
+		}
 
-	// Print each of the 5 columns of pixels in the font.
-	for (int8_t i = FONT_WIDTH - 1; i >= 0; i--) {
-		// Reset the Y position just in case it moved.
-		lcd_command(PCD8544_SETYADDR, pos_y);
+		while (budget && pump_remaining) {
+			if (pump_entry & QUEUE_GLYPH) {
+				lcd_shift_byte(lcd_glyph_column(pump_entry,
+												GLYPH_COLUMNS - pump_remaining));
+			} else {
+				lcd_shift_byte(pump_entry);
+			}
 
-		// Send the actual column.
-		lcd_command(0, font[c - 0x20][i]);
+			pump_remaining--;
+			budget--;
+		}
 	}
-#else
-	for (int8_t i = 0; i < FONT_WIDTH; i++) {
-		lcd_command(0, font[c - 0x20][i]);
+
+	// Finish the packet and clean the mess once everything is out.
+	if (!lcd_busy()) {
+		P2OUT |= EN;
+		P2OUT &= ~(SCLK + MOSI + D_C);
 	}
+}
 
-	lcd_command(0, 0);
-#endif
+/**
+ *  Checks if there's still stuff being sent to the display.
+ *
+ *  @return TRUE if the output queue isn't empty yet.
+ */
+bool lcd_busy() {
+	return (queue_head != queue_tail) || pump_remaining;
+}
+
+/**
+ *  Waits until the output queue has at most a number of entries, sleeping in
+ *  LPM0 while the interrupt does its thing.
+ *
+ *  @param entries Maximum number of entries left in the queue.
+ */
+void lcd_wait(const uint8_t entries) {
+	unsigned int state = __get_interrupt_state();
+
+	__disable_interrupt();
+	while (((queue_head - queue_tail) & (LCD_QUEUE_SIZE - 1)) > entries ||
+		   ((entries == 0) && pump_remaining)) {
+		if (!(state & GIE)) {
+			// Interrupts are disabled (we are inside a ISR), so nobody is
+			// going to do it for us.
+			lcd_pump();
+			continue;
+		}
+
+		lcd_waiting = true;
+		__bis_SR_register(LPM0_bits + GIE);  // Sleep until the pump wakes us.
+		__disable_interrupt();
+		lcd_waiting = false;
+	}
+
+	__set_interrupt_state(state);
+}
+
+/**
+ *  Clocks a byte out to the controller, most significant bit first. Each bit
+ *  is a couple of straight port writes, no calls or variable shifts.
+ *
+ *  @param b Byte to be sent.
+ */
+inline void lcd_shift_byte(const uint8_t b) {
+	LCD_SHIFT_BIT(b, BIT7);
+	LCD_SHIFT_BIT(b, BIT6);
+	LCD_SHIFT_BIT(b, BIT5);
+	LCD_SHIFT_BIT(b, BIT4);
+	LCD_SHIFT_BIT(b, BIT3);
+	LCD_SHIFT_BIT(b, BIT2);
+	LCD_SHIFT_BIT(b, BIT1);
+	LCD_SHIFT_BIT(b, BIT0);
+}
+
+/**
+ *  Prints a character on the screen.
+ *
+ *  @param c A character.
+ */
+void lcd_putc(const char c) {
+	lcd_putc(c, NORMAL);
 }
 
 /**
@@ -135,67 +340,12 @@ void lcd_putc(const char c) {
 void lcd_putc(const char c, uint8_t effect) {
 #ifdef ROTATION_ENABLE
 	// Move the cursor 6 columns to make space for the letter.
-	pos_x -= 6;
-	lcd_command(PCD8544_SETXADDR, pos_x);
-
-	switch (effect) {
-	case INVERTED:
-		lcd_command(0, 0xff);
-		break;
-	case UNDERLINED:
-		lcd_command(0, 0b00000001);
-		break;
-	default:
-		// Send a blank column to separate from the next character.
-		lcd_command(0, 0);
-		break;
-	}
-
-	// Print each of the 5 collumns of pixels in the font.
-	for (int8_t i = FONT_WIDTH - 1; i >= 0; i--) {
-		// Reset the Y position just in case it moved.
-		lcd_command(PCD8544_SETYADDR, pos_y);
-
-		// Send the actual column.
-		switch (effect) {
-		case INVERTED:
-			lcd_command(0, ~(font[c - 0x20][i]));
-			break;
-		case UNDERLINED:
-			lcd_command(0, font[c - 0x20][i] ^ 0b00000001);
-			break;
-		default:
-			lcd_command(0, font[c - 0x20][i]);
-			break;
-		}
-	}
-#else
-	for (int8_t i = 0; i < 5; i++) {
-		switch (effect) {
-		case INVERTED:
-			lcd_command(0, ~(font[c - 0x20][i]));
-			break;
-		case UNDERLINED:
-			lcd_command(0, font[c - 0x20][i] ^ 0b10000000);
-			break;
-		default:
-			lcd_command(0, font[c - 0x20][i]);
-			break;
-		}
-	}
-
-	switch (effect) {
-	case INVERTED:
-		lcd_command(0, 0xff);
-		break;
-	case UNDERLINED:
-		lcd_command(0, 0b10000000);
-		break;
-	default:
-		lcd_command(0, 0);
-		break;
-	}
+	pos_x -= FONT_WIDTH + 1;
+	lcd_command(PCD8544_SETXADDR, pos_x + 1);
+	lcd_command(PCD8544_SETYADDR, pos_y);
 #endif
+
+	lcd_put_glyph(c, effect);
 }
 
 /**
@@ -204,9 +354,7 @@ void lcd_putc(const char c, uint8_t effect) {
  *  @param string A string of characters.
  */
 void lcd_print(const char *string) {
-	while (*string) {
-		lcd_putc(*string++);
-	}
+	lcd_print(string, NORMAL);
 }
 
 /**
@@ -216,9 +364,68 @@ void lcd_print(const char *string) {
  *  @param effect Font effect.
  */
 void lcd_print(const char *string, uint8_t effect) {
+#ifdef ROTATION_ENABLE
+	// Upside down the string goes from right to left, so we make space for the
+	// whole thing and send it backwards in a single run.
+	uint8_t len = strlen(string);
+
+	pos_x -= len * (FONT_WIDTH + 1);
+	lcd_command(PCD8544_SETXADDR, pos_x + 1);
+	lcd_command(PCD8544_SETYADDR, pos_y);
+
+	while (len--) {
+		lcd_put_glyph(string[len], effect);
+	}
+#else
 	while (*string) {
-		lcd_putc(*string++, effect);
+		lcd_put_glyph(*string++, effect);
 	}
+#endif
+}
+
+/**
+ *  Queues a character, with its spacing column, at the current address.
+ *
+ *  @param c A character.
+ *  @param effect Font effect.
+ */
+void lcd_put_glyph(const char c, uint8_t effect) {
+	lcd_enqueue(QUEUE_GLYPH | QUEUE_DATA | (effect << QUEUE_COUNT_SHIFT) |
+				(uint8_t)c, 1);
+}
+
+/**
+ *  Gets a column of a queued glyph, effect included.
+ *
+ *  @param entry Glyph queue entry.
+ *  @param column Column to get, spacing included.
+ *  @return Column of pixels.
+ */
+uint8_t lcd_glyph_column(const uint16_t entry, const uint8_t column) {
+	uint8_t b = 0;
+
+#ifdef ROTATION_ENABLE
+	// The spacing column comes first when upside down.
+	if (column > 0) {
+		b = font[(uint8_t)entry - 0x20][column - 1];
+	}
+#else
+	if (column < FONT_WIDTH) {
+		b = font[(uint8_t)entry - 0x20][column];
+	}
+#endif
+
+	// Apply the effect.
+	switch (QUEUE_EFFECT(entry)) {
+	case INVERTED:
+		b ^= 0xff;
+		break;
+	case UNDERLINED:
+		b ^= LCD_COLUMN(0b10000000);
+		break;
+	}
+
+	return b;
 }
 
 /**
@@ -229,9 +436,7 @@ void lcd_clear() {
 	lcd_set_pos(0, 0);
 
 	// Fill the whole screen with blank pixels.
-	for (unsigned int i = 0; i < (LCDWIDTH * (LCDHEIGHT / 8)); i++) {
-		lcd_command(0, 0);
-	}
+	lcd_fill(0, LCDWIDTH * LCDBANKS);
 
 	// Go back to (0,0).
 	lcd_set_pos(0, 0);
@@ -248,18 +453,13 @@ void lcd_clear_row(unsigned int row) {
 	lcd_set_pos(0, PCD8544_HEIGHT - row);
 
 	// Fill the row with blank pixels.
-	for (unsigned int i = 0; i < LCDWIDTH; i++) {
-		lcd_command(0, 0);
-	}
+	lcd_fill(0, LCDWIDTH);
 
 	// Go back to where everything started.
 	lcd_set_pos(0, PCD8544_HEIGHT - row);
 #else
 	lcd_set_pos(0, row);
-
-	for (unsigned int i = 0; i < LCDWIDTH; i++) {
-		lcd_command(0, 0);
-	}
+	lcd_fill(0, LCDWIDTH);
 
 	lcd_set_pos(0, row);
 #endif
@@ -292,3 +492,33 @@ void lcd_set_pos(unsigned int x, unsigned int y) {
 	lcd_command(PCD8544_SETYADDR, y);
 #endif
 }
+
+/**
+ *  Waits for everything in the output queue to get to the display.
+ */
+void lcd_flush() {
+	lcd_flush_async();
+	lcd_wait(0);
+}
+
+// Timer1_A CCR1 interrupt service routine. (LCD output queue)
+#pragma vector = TIMER1_A1_VECTOR
+__interrupt void Timer1_A1_ISR(void) {
+	switch (__even_in_range(TA1IV, TA1IV_TAIFG)) {
+	case TA1IV_TACCR1:
+		lcd_pump();
+
+		// Schedule the next batch or stop if we are done.
+		if (lcd_busy()) {
+			TA1CCR1 += LCD_PUMP_COUNTS;
+		} else {
+			TA1CCTL1 &= ~CCIE;
+		}
+
+		// Someone is waiting for us.
+		if (lcd_waiting) {
+			__bic_SR_register_on_exit(CPUOFF);
+		}
+		break;
+	}
+}
@@ -11,6 +11,7 @@
 #define LCD_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 
 // Function Set bits (PD, V, H).
 #define PCD8544_POWERDOWN       0b00000100
@@ -40,6 +41,12 @@
 #define PCD8544_WIDTH   83
 #define PCD8544_HEIGHT  5
 
+// Everything is sent in the background by the Timer1_A CCR1 interrupt, a few
+// bytes at a time, from a queue of run-length and glyph entries.
+#define LCD_QUEUE_SIZE  32   // Entries, must be a power of 2.
+#define LCD_PUMP_BYTES  4    // Bytes sent per interrupt.
+#define LCD_PUMP_COUNTS 128  // Timer1_A counts between interrupts. (64us)
+
 // Font effects.
 #define NORMAL     0
 #define INVERTED   1
@@ -48,8 +55,11 @@
 // Function Prototypes.
 void lcd_setup();
 void lcd_init();
+void lcd_powerdown();
+void lcd_powerup();
 
 void lcd_command(const char command, const char data);
+void lcd_fill(const uint8_t data, unsigned int len);
 
 void lcd_putc(const char c);
 void lcd_putc(const char c, uint8_t effect);
@@ -61,205 +71,134 @@ void lcd_clear_row(unsigned int row);
 
 void lcd_set_pos(unsigned int x, unsigned int y);
 
-// Fonts.
+void lcd_flush();
+void lcd_flush_async();
+bool lcd_busy();
+
+// Flips a column of pixels upside down.
+#define BIT_REVERSE(b) ((((b) & 0x01) << 7) | (((b) & 0x02) << 5) | \
+						(((b) & 0x04) << 3) | (((b) & 0x08) << 1) | \
+						(((b) & 0x10) >> 1) | (((b) & 0x20) >> 3) | \
+						(((b) & 0x40) >> 5) | (((b) & 0x80) >> 7))
+
+// Puts a column of pixels in the display orientation.
 #ifdef ROTATION_ENABLE
-static const char font[][FONT_WIDTH] = {
-	{ 0x00, 0x00, 0x00, 0x00, 0x00 },
-	{ 0x00, 0x00, 0xfa, 0x00, 0x00 },
-	{ 0x00, 0xe0, 0x00, 0xe0, 0x00 },
-	{ 0x28, 0xfe, 0x28, 0xfe, 0x28 },
-	{ 0x24, 0x54, 0xfe, 0x54, 0x48 },
-	{ 0xc4, 0xc8, 0x10, 0x26, 0x46 },
-	{ 0x6c, 0x92, 0xaa, 0x44, 0x0a },
-	{ 0x00, 0xa0, 0xc0, 0x00, 0x00 },
-	{ 0x00, 0x38, 0x44, 0x82, 0x00 },
-	{ 0x00, 0x82, 0x44, 0x38, 0x00 },
-	{ 0x28, 0x10, 0x7c, 0x10, 0x28 },
-	{ 0x10, 0x10, 0x7c, 0x10, 0x10 },
-	{ 0x00, 0x0a, 0x0c, 0x00, 0x00 },
-	{ 0x10, 0x10, 0x10, 0x10, 0x10 },
-	{ 0x00, 0x06, 0x06, 0x00, 0x00 },
-	{ 0x04, 0x08, 0x10, 0x20, 0x40 },
-	{ 0x7c, 0x8a, 0x92, 0xa2, 0x7c },
-	{ 0x00, 0x42, 0xfe, 0x02, 0x00 },
-	{ 0x42, 0x86, 0x8a, 0x92, 0x62 },
-	{ 0x84, 0x82, 0xa2, 0xd2, 0x8c },
-	{ 0x18, 0x28, 0x48, 0xfe, 0x08 },
-	{ 0xe4, 0xa2, 0xa2, 0xa2, 0x9c },
-	{ 0x3c, 0x52, 0x92, 0x92, 0x0c },
-	{ 0x80, 0x8e, 0x90, 0xa0, 0xc0 },
-	{ 0x6c, 0x92, 0x92, 0x92, 0x6c },
-	{ 0x60, 0x92, 0x92, 0x94, 0x78 },
-	{ 0x00, 0x6c, 0x6c, 0x00, 0x00 },
-	{ 0x00, 0x6a, 0x6c, 0x00, 0x00 },
-	{ 0x10, 0x28, 0x44, 0x82, 0x00 },
-	{ 0x28, 0x28, 0x28, 0x28, 0x28 },
-	{ 0x00, 0x82, 0x44, 0x28, 0x10 },
-	{ 0x40, 0x80, 0x8a, 0x90, 0x60 },
-	{ 0x4c, 0x92, 0x9e, 0x82, 0x7c },
-	{ 0x7e, 0x88, 0x88, 0x88, 0x7e },
-	{ 0xfe, 0x92, 0x92, 0x92, 0x6c },
-	{ 0x7c, 0x82, 0x82, 0x82, 0x44 },
-	{ 0xfe, 0x82, 0x82, 0x44, 0x38 },
-	{ 0xfe, 0x92, 0x92, 0x92, 0x82 },
-	{ 0xfe, 0x90, 0x90, 0x90, 0x80 },
-	{ 0x7c, 0x82, 0x92, 0x92, 0x5e },
-	{ 0xfe, 0x10, 0x10, 0x10, 0xfe },
-	{ 0x00, 0x82, 0xfe, 0x82, 0x00 },
-	{ 0x04, 0x02, 0x82, 0xfc, 0x80 },
-	{ 0xfe, 0x10, 0x28, 0x44, 0x82 },
-	{ 0xfe, 0x02, 0x02, 0x02, 0x02 },
-	{ 0xfe, 0x40, 0x30, 0x40, 0xfe },
-	{ 0xfe, 0x20, 0x10, 0x08, 0xfe },
-	{ 0x7c, 0x82, 0x82, 0x82, 0x7c },
-	{ 0xfe, 0x90, 0x90, 0x90, 0x60 },
-	{ 0x7c, 0x82, 0x8a, 0x84, 0x7a },
-	{ 0xfe, 0x90, 0x98, 0x94, 0x62 },
-	{ 0x62, 0x92, 0x92, 0x92, 0x8c },
-	{ 0x80, 0x80, 0xfe, 0x80, 0x80 },
-	{ 0xfc, 0x02, 0x02, 0x02, 0xfc },
-	{ 0xf8, 0x04, 0x02, 0x04, 0xf8 },
-	{ 0xfc, 0x02, 0x1c, 0x02, 0xfc },
-	{ 0xc6, 0x28, 0x10, 0x28, 0xc6 },
-	{ 0xe0, 0x10, 0x0e, 0x10, 0xe0 },
-	{ 0x86, 0x8a, 0x92, 0xa2, 0xc2 },
-	{ 0x00, 0xfe, 0x82, 0x82, 0x00 },
-	{ 0x40, 0x20, 0x10, 0x08, 0x04 },
-	{ 0x00, 0x82, 0x82, 0xfe, 0x00 },
-	{ 0x20, 0x40, 0x80, 0x40, 0x20 },
-	{ 0x02, 0x02, 0x02, 0x02, 0x02 },
-	{ 0x00, 0x80, 0x40, 0x20, 0x00 },
-	{ 0x04, 0x2a, 0x2a, 0x2a, 0x1e },
-	{ 0xfe, 0x12, 0x22, 0x22, 0x1c },
-	{ 0x1c, 0x22, 0x22, 0x22, 0x04 },
-	{ 0x1c, 0x22, 0x22, 0x12, 0xfe },
-	{ 0x1c, 0x2a, 0x2a, 0x2a, 0x18 },
-	{ 0x10, 0x7e, 0x90, 0x80, 0x40 },
-	{ 0x30, 0x4a, 0x4a, 0x4a, 0x7c },
-	{ 0xfe, 0x10, 0x20, 0x20, 0x1e },
-	{ 0x00, 0x22, 0xbe, 0x02, 0x00 },
-	{ 0x04, 0x02, 0x22, 0xbc, 0x00 },
-	{ 0xfe, 0x08, 0x14, 0x22, 0x00 },
-	{ 0x00, 0x82, 0xfe, 0x02, 0x00 },
-	{ 0x3e, 0x20, 0x18, 0x20, 0x1e },
-	{ 0x3e, 0x10, 0x20, 0x20, 0x1e },
-	{ 0x1c, 0x22, 0x22, 0x22, 0x1c },
-	{ 0x3e, 0x28, 0x28, 0x28, 0x10 },
-	{ 0x10, 0x28, 0x28, 0x18, 0x3e },
-	{ 0x3e, 0x10, 0x20, 0x20, 0x10 },
-	{ 0x12, 0x2a, 0x2a, 0x2a, 0x04 },
-	{ 0x20, 0xfc, 0x22, 0x02, 0x04 },
-	{ 0x3c, 0x02, 0x02, 0x04, 0x3e },
-	{ 0x38, 0x04, 0x02, 0x04, 0x38 },
-	{ 0x3c, 0x02, 0x0c, 0x02, 0x3c },
-	{ 0x22, 0x14, 0x08, 0x14, 0x22 },
-	{ 0x30, 0x0a, 0x0a, 0x0a, 0x3c },
-	{ 0x22, 0x26, 0x2a, 0x32, 0x22 },
-	{ 0x00, 0x10, 0x6c, 0x82, 0x00 },
-	{ 0x00, 0x00, 0xfe, 0x00, 0x00 },
-	{ 0x00, 0x82, 0x6c, 0x10, 0x00 },
-	{ 0x08, 0x10, 0x10, 0x08, 0x10 },
-	{ 0x00, 0x60, 0x90, 0x90, 0x60 }
-};
+#define LCD_COLUMN(b) BIT_REVERSE(b)
 #else
-static const char font[][FONT_WIDTH] = {
-	 {0x00, 0x00, 0x00, 0x00, 0x00} // 20
-	,{0x00, 0x00, 0x5f, 0x00, 0x00} // 21 !
-	,{0x00, 0x07, 0x00, 0x07, 0x00} // 22 "
-	,{0x14, 0x7f, 0x14, 0x7f, 0x14} // 23 #
-	,{0x24, 0x2a, 0x7f, 0x2a, 0x12} // 24 $
-	,{0x23, 0x13, 0x08, 0x64, 0x62} // 25 %
-	,{0x36, 0x49, 0x55, 0x22, 0x50} // 26 &
-	,{0x00, 0x05, 0x03, 0x00, 0x00} // 27 '
-	,{0x00, 0x1c, 0x22, 0x41, 0x00} // 28 (
-	,{0x00, 0x41, 0x22, 0x1c, 0x00} // 29 )
-	,{0x14, 0x08, 0x3e, 0x08, 0x14} // 2a *
-	,{0x08, 0x08, 0x3e, 0x08, 0x08} // 2b +
-	,{0x00, 0x50, 0x30, 0x00, 0x00} // 2c ,
-	,{0x08, 0x08, 0x08, 0x08, 0x08} // 2d -
-	,{0x00, 0x60, 0x60, 0x00, 0x00} // 2e .
-	,{0x20, 0x10, 0x08, 0x04, 0x02} // 2f /
-	,{0x3e, 0x51, 0x49, 0x45, 0x3e} // 30 0
-	,{0x00, 0x42, 0x7f, 0x40, 0x00} // 31 1
-	,{0x42, 0x61, 0x51, 0x49, 0x46} // 32 2
-	,{0x21, 0x41, 0x45, 0x4b, 0x31} // 33 3
-	,{0x18, 0x14, 0x12, 0x7f, 0x10} // 34 4
-	,{0x27, 0x45, 0x45, 0x45, 0x39} // 35 5
-	,{0x3c, 0x4a, 0x49, 0x49, 0x30} // 36 6
-	,{0x01, 0x71, 0x09, 0x05, 0x03} // 37 7
-	,{0x36, 0x49, 0x49, 0x49, 0x36} // 38 8
-	,{0x06, 0x49, 0x49, 0x29, 0x1e} // 39 9
-	,{0x00, 0x36, 0x36, 0x00, 0x00} // 3a :
-	,{0x00, 0x56, 0x36, 0x00, 0x00} // 3b ;
-	,{0x08, 0x14, 0x22, 0x41, 0x00} // 3c <
-	,{0x14, 0x14, 0x14, 0x14, 0x14} // 3d =
-	,{0x00, 0x41, 0x22, 0x14, 0x08} // 3e >
-	,{0x02, 0x01, 0x51, 0x09, 0x06} // 3f ?
-	,{0x32, 0x49, 0x79, 0x41, 0x3e} // 40 @
-	,{0x7e, 0x11, 0x11, 0x11, 0x7e} // 41 A
-	,{0x7f, 0x49, 0x49, 0x49, 0x36} // 42 B
-	,{0x3e, 0x41, 0x41, 0x41, 0x22} // 43 C
-	,{0x7f, 0x41, 0x41, 0x22, 0x1c} // 44 D
-	,{0x7f, 0x49, 0x49, 0x49, 0x41} // 45 E
-	,{0x7f, 0x09, 0x09, 0x09, 0x01} // 46 F
-	,{0x3e, 0x41, 0x49, 0x49, 0x7a} // 47 G
-	,{0x7f, 0x08, 0x08, 0x08, 0x7f} // 48 H
-	,{0x00, 0x41, 0x7f, 0x41, 0x00} // 49 I
-	,{0x20, 0x40, 0x41, 0x3f, 0x01} // 4a J
-	,{0x7f, 0x08, 0x14, 0x22, 0x41} // 4b K
-	,{0x7f, 0x40, 0x40, 0x40, 0x40} // 4c L
-	,{0x7f, 0x02, 0x0c, 0x02, 0x7f} // 4d M
-	,{0x7f, 0x04, 0x08, 0x10, 0x7f} // 4e N
-	,{0x3e, 0x41, 0x41, 0x41, 0x3e} // 4f O
-	,{0x7f, 0x09, 0x09, 0x09, 0x06} // 50 P
-	,{0x3e, 0x41, 0x51, 0x21, 0x5e} // 51 Q
-	,{0x7f, 0x09, 0x19, 0x29, 0x46} // 52 R
-	,{0x46, 0x49, 0x49, 0x49, 0x31} // 53 S
-	,{0x01, 0x01, 0x7f, 0x01, 0x01} // 54 T
-	,{0x3f, 0x40, 0x40, 0x40, 0x3f} // 55 U
-	,{0x1f, 0x20, 0x40, 0x20, 0x1f} // 56 V
-	,{0x3f, 0x40, 0x38, 0x40, 0x3f} // 57 W
-	,{0x63, 0x14, 0x08, 0x14, 0x63} // 58 X
-	,{0x07, 0x08, 0x70, 0x08, 0x07} // 59 Y
-	,{0x61, 0x51, 0x49, 0x45, 0x43} // 5a Z
-	,{0x00, 0x7f, 0x41, 0x41, 0x00} // 5b [
-	,{0x02, 0x04, 0x08, 0x10, 0x20} // 5c ¥
-	,{0x00, 0x41, 0x41, 0x7f, 0x00} // 5d ]
-	,{0x04, 0x02, 0x01, 0x02, 0x04} // 5e ^
-	,{0x40, 0x40, 0x40, 0x40, 0x40} // 5f _
-	,{0x00, 0x01, 0x02, 0x04, 0x00} // 60 `
-	,{0x20, 0x54, 0x54, 0x54, 0x78} // 61 a
-	,{0x7f, 0x48, 0x44, 0x44, 0x38} // 62 b
-	,{0x38, 0x44, 0x44, 0x44, 0x20} // 63 c
-	,{0x38, 0x44, 0x44, 0x48, 0x7f} // 64 d
-	,{0x38, 0x54, 0x54, 0x54, 0x18} // 65 e
-	,{0x08, 0x7e, 0x09, 0x01, 0x02} // 66 f
-	,{0x0c, 0x52, 0x52, 0x52, 0x3e} // 67 g
-	,{0x7f, 0x08, 0x04, 0x04, 0x78} // 68 h
-	,{0x00, 0x44, 0x7d, 0x40, 0x00} // 69 i
-	,{0x20, 0x40, 0x44, 0x3d, 0x00} // 6a j
-	,{0x7f, 0x10, 0x28, 0x44, 0x00} // 6b k
-	,{0x00, 0x41, 0x7f, 0x40, 0x00} // 6c l
-	,{0x7c, 0x04, 0x18, 0x04, 0x78} // 6d m
-	,{0x7c, 0x08, 0x04, 0x04, 0x78} // 6e n
-	,{0x38, 0x44, 0x44, 0x44, 0x38} // 6f o
-	,{0x7c, 0x14, 0x14, 0x14, 0x08} // 70 p
-	,{0x08, 0x14, 0x14, 0x18, 0x7c} // 71 q
-	,{0x7c, 0x08, 0x04, 0x04, 0x08} // 72 r
-	,{0x48, 0x54, 0x54, 0x54, 0x20} // 73 s
-	,{0x04, 0x3f, 0x44, 0x40, 0x20} // 74 t
-	,{0x3c, 0x40, 0x40, 0x20, 0x7c} // 75 u
-	,{0x1c, 0x20, 0x40, 0x20, 0x1c} // 76 v
-	,{0x3c, 0x40, 0x30, 0x40, 0x3c} // 77 w
-	,{0x44, 0x28, 0x10, 0x28, 0x44} // 78 x
-	,{0x0c, 0x50, 0x50, 0x50, 0x3c} // 79 y
-	,{0x44, 0x64, 0x54, 0x4c, 0x44} // 7a z
-	,{0x00, 0x08, 0x36, 0x41, 0x00} // 7b {
-	,{0x00, 0x00, 0x7f, 0x00, 0x00} // 7c |
-	,{0x00, 0x41, 0x36, 0x08, 0x00} // 7d }
-	,{0x10, 0x08, 0x08, 0x10, 0x08} // 7e ~
-	,{0x00, 0x06, 0x09, 0x09, 0x06} // 7f Deg Symbol
-};
+#define LCD_COLUMN(b) (b)
+#endif
+
+// Font glyphs, columns from left to right with the LSB at the top.
+#define FONT_GLYPHS \
+	FONT_GLYPH(0x00, 0x00, 0x00, 0x00, 0x00)  /* 20 */ \
+	FONT_GLYPH(0x00, 0x00, 0x5f, 0x00, 0x00)  /* 21 ! */ \
+	FONT_GLYPH(0x00, 0x07, 0x00, 0x07, 0x00)  /* 22 " */ \
+	FONT_GLYPH(0x14, 0x7f, 0x14, 0x7f, 0x14)  /* 23 # */ \
+	FONT_GLYPH(0x24, 0x2a, 0x7f, 0x2a, 0x12)  /* 24 $ */ \
+	FONT_GLYPH(0x23, 0x13, 0x08, 0x64, 0x62)  /* 25 % */ \
+	FONT_GLYPH(0x36, 0x49, 0x55, 0x22, 0x50)  /* 26 & */ \
+	FONT_GLYPH(0x00, 0x05, 0x03, 0x00, 0x00)  /* 27 ' */ \
+	FONT_GLYPH(0x00, 0x1c, 0x22, 0x41, 0x00)  /* 28 ( */ \
+	FONT_GLYPH(0x00, 0x41, 0x22, 0x1c, 0x00)  /* 29 ) */ \
+	FONT_GLYPH(0x14, 0x08, 0x3e, 0x08, 0x14)  /* 2a * */ \
+	FONT_GLYPH(0x08, 0x08, 0x3e, 0x08, 0x08)  /* 2b + */ \
+	FONT_GLYPH(0x00, 0x50, 0x30, 0x00, 0x00)  /* 2c , */ \
+	FONT_GLYPH(0x08, 0x08, 0x08, 0x08, 0x08)  /* 2d - */ \
+	FONT_GLYPH(0x00, 0x60, 0x60, 0x00, 0x00)  /* 2e . */ \
+	FONT_GLYPH(0x20, 0x10, 0x08, 0x04, 0x02)  /* 2f / */ \
+	FONT_GLYPH(0x3e, 0x51, 0x49, 0x45, 0x3e)  /* 30 0 */ \
+	FONT_GLYPH(0x00, 0x42, 0x7f, 0x40, 0x00)  /* 31 1 */ \
+	FONT_GLYPH(0x42, 0x61, 0x51, 0x49, 0x46)  /* 32 2 */ \
+	FONT_GLYPH(0x21, 0x41, 0x45, 0x4b, 0x31)  /* 33 3 */ \
+	FONT_GLYPH(0x18, 0x14, 0x12, 0x7f, 0x10)  /* 34 4 */ \
+	FONT_GLYPH(0x27, 0x45, 0x45, 0x45, 0x39)  /* 35 5 */ \
+	FONT_GLYPH(0x3c, 0x4a, 0x49, 0x49, 0x30)  /* 36 6 */ \
+	FONT_GLYPH(0x01, 0x71, 0x09, 0x05, 0x03)  /* 37 7 */ \
+	FONT_GLYPH(0x36, 0x49, 0x49, 0x49, 0x36)  /* 38 8 */ \
+	FONT_GLYPH(0x06, 0x49, 0x49, 0x29, 0x1e)  /* 39 9 */ \
+	FONT_GLYPH(0x00, 0x36, 0x36, 0x00, 0x00)  /* 3a : */ \
+	FONT_GLYPH(0x00, 0x56, 0x36, 0x00, 0x00)  /* 3b ; */ \
+	FONT_GLYPH(0x08, 0x14, 0x22, 0x41, 0x00)  /* 3c < */ \
+	FONT_GLYPH(0x14, 0x14, 0x14, 0x14, 0x14)  /* 3d = */ \
+	FONT_GLYPH(0x00, 0x41, 0x22, 0x14, 0x08)  /* 3e > */ \
+	FONT_GLYPH(0x02, 0x01, 0x51, 0x09, 0x06)  /* 3f ? */ \
+	FONT_GLYPH(0x32, 0x49, 0x79, 0x41, 0x3e)  /* 40 @ */ \
+	FONT_GLYPH(0x7e, 0x11, 0x11, 0x11, 0x7e)  /* 41 A */ \
+	FONT_GLYPH(0x7f, 0x49, 0x49, 0x49, 0x36)  /* 42 B */ \
+	FONT_GLYPH(0x3e, 0x41, 0x41, 0x41, 0x22)  /* 43 C */ \
+	FONT_GLYPH(0x7f, 0x41, 0x41, 0x22, 0x1c)  /* 44 D */ \
+	FONT_GLYPH(0x7f, 0x49, 0x49, 0x49, 0x41)  /* 45 E */ \
+	FONT_GLYPH(0x7f, 0x09, 0x09, 0x09, 0x01)  /* 46 F */ \
+	FONT_GLYPH(0x3e, 0x41, 0x49, 0x49, 0x7a)  /* 47 G */ \
+	FONT_GLYPH(0x7f, 0x08, 0x08, 0x08, 0x7f)  /* 48 H */ \
+	FONT_GLYPH(0x00, 0x41, 0x7f, 0x41, 0x00)  /* 49 I */ \
+	FONT_GLYPH(0x20, 0x40, 0x41, 0x3f, 0x01)  /* 4a J */ \
+	FONT_GLYPH(0x7f, 0x08, 0x14, 0x22, 0x41)  /* 4b K */ \
+	FONT_GLYPH(0x7f, 0x40, 0x40, 0x40, 0x40)  /* 4c L */ \
+	FONT_GLYPH(0x7f, 0x02, 0x0c, 0x02, 0x7f)  /* 4d M */ \
+	FONT_GLYPH(0x7f, 0x04, 0x08, 0x10, 0x7f)  /* 4e N */ \
+	FONT_GLYPH(0x3e, 0x41, 0x41, 0x41, 0x3e)  /* 4f O */ \
+	FONT_GLYPH(0x7f, 0x09, 0x09, 0x09, 0x06)  /* 50 P */ \
+	FONT_GLYPH(0x3e, 0x41, 0x51, 0x21, 0x5e)  /* 51 Q */ \
+	FONT_GLYPH(0x7f, 0x09, 0x19, 0x29, 0x46)  /* 52 R */ \
+	FONT_GLYPH(0x46, 0x49, 0x49, 0x49, 0x31)  /* 53 S */ \
+	FONT_GLYPH(0x01, 0x01, 0x7f, 0x01, 0x01)  /* 54 T */ \
+	FONT_GLYPH(0x3f, 0x40, 0x40, 0x40, 0x3f)  /* 55 U */ \
+	FONT_GLYPH(0x1f, 0x20, 0x40, 0x20, 0x1f)  /* 56 V */ \
+	FONT_GLYPH(0x3f, 0x40, 0x38, 0x40, 0x3f)  /* 57 W */ \
+	FONT_GLYPH(0x63, 0x14, 0x08, 0x14, 0x63)  /* 58 X */ \
+	FONT_GLYPH(0x07, 0x08, 0x70, 0x08, 0x07)  /* 59 Y */ \
+	FONT_GLYPH(0x61, 0x51, 0x49, 0x45, 0x43)  /* 5a Z */ \
+	FONT_GLYPH(0x00, 0x7f, 0x41, 0x41, 0x00)  /* 5b [ */ \
+	FONT_GLYPH(0x02, 0x04, 0x08, 0x10, 0x20)  /* 5c ¥ */ \
+	FONT_GLYPH(0x00, 0x41, 0x41, 0x7f, 0x00)  /* 5d ] */ \
+	FONT_GLYPH(0x04, 0x02, 0x01, 0x02, 0x04)  /* 5e ^ */ \
+	FONT_GLYPH(0x40, 0x40, 0x40, 0x40, 0x40)  /* 5f _ */ \
+	FONT_GLYPH(0x00, 0x01, 0x02, 0x04, 0x00)  /* 60 ` */ \
+	FONT_GLYPH(0x20, 0x54, 0x54, 0x54, 0x78)  /* 61 a */ \
+	FONT_GLYPH(0x7f, 0x48, 0x44, 0x44, 0x38)  /* 62 b */ \
+	FONT_GLYPH(0x38, 0x44, 0x44, 0x44, 0x20)  /* 63 c */ \
+	FONT_GLYPH(0x38, 0x44, 0x44, 0x48, 0x7f)  /* 64 d */ \
+	FONT_GLYPH(0x38, 0x54, 0x54, 0x54, 0x18)  /* 65 e */ \
+	FONT_GLYPH(0x08, 0x7e, 0x09, 0x01, 0x02)  /* 66 f */ \
+	FONT_GLYPH(0x0c, 0x52, 0x52, 0x52, 0x3e)  /* 67 g */ \
+	FONT_GLYPH(0x7f, 0x08, 0x04, 0x04, 0x78)  /* 68 h */ \
+	FONT_GLYPH(0x00, 0x44, 0x7d, 0x40, 0x00)  /* 69 i */ \
+	FONT_GLYPH(0x20, 0x40, 0x44, 0x3d, 0x00)  /* 6a j */ \
+	FONT_GLYPH(0x7f, 0x10, 0x28, 0x44, 0x00)  /* 6b k */ \
+	FONT_GLYPH(0x00, 0x41, 0x7f, 0x40, 0x00)  /* 6c l */ \
+	FONT_GLYPH(0x7c, 0x04, 0x18, 0x04, 0x78)  /* 6d m */ \
+	FONT_GLYPH(0x7c, 0x08, 0x04, 0x04, 0x78)  /* 6e n */ \
+	FONT_GLYPH(0x38, 0x44, 0x44, 0x44, 0x38)  /* 6f o */ \
+	FONT_GLYPH(0x7c, 0x14, 0x14, 0x14, 0x08)  /* 70 p */ \
+	FONT_GLYPH(0x08, 0x14, 0x14, 0x18, 0x7c)  /* 71 q */ \
+	FONT_GLYPH(0x7c, 0x08, 0x04, 0x04, 0x08)  /* 72 r */ \
+	FONT_GLYPH(0x48, 0x54, 0x54, 0x54, 0x20)  /* 73 s */ \
+	FONT_GLYPH(0x04, 0x3f, 0x44, 0x40, 0x20)  /* 74 t */ \
+	FONT_GLYPH(0x3c, 0x40, 0x40, 0x20, 0x7c)  /* 75 u */ \
+	FONT_GLYPH(0x1c, 0x20, 0x40, 0x20, 0x1c)  /* 76 v */ \
+	FONT_GLYPH(0x3c, 0x40, 0x30, 0x40, 0x3c)  /* 77 w */ \
+	FONT_GLYPH(0x44, 0x28, 0x10, 0x28, 0x44)  /* 78 x */ \
+	FONT_GLYPH(0x0c, 0x50, 0x50, 0x50, 0x3c)  /* 79 y */ \
+	FONT_GLYPH(0x44, 0x64, 0x54, 0x4c, 0x44)  /* 7a z */ \
+	FONT_GLYPH(0x00, 0x08, 0x36, 0x41, 0x00)  /* 7b { */ \
+	FONT_GLYPH(0x00, 0x00, 0x7f, 0x00, 0x00)  /* 7c | */ \
+	FONT_GLYPH(0x00, 0x41, 0x36, 0x08, 0x00)  /* 7d } */ \
+	FONT_GLYPH(0x10, 0x08, 0x08, 0x10, 0x08)  /* 7e ~ */ \
+	FONT_GLYPH(0x00, 0x06, 0x09, 0x09, 0x06)  /* 7f Deg Symbol */
+
+// Fonts. When rotated the glyphs are stored upside down and mirrored, so each
+// one can be streamed left to right with the address auto-increment.
+#ifdef ROTATION_ENABLE
+#define FONT_GLYPH(c0, c1, c2, c3, c4) \
+		{ BIT_REVERSE(c4), BIT_REVERSE(c3), BIT_REVERSE(c2), BIT_REVERSE(c1), \
+		  BIT_REVERSE(c0) },
+#else
+#define FONT_GLYPH(c0, c1, c2, c3, c4) { c0, c1, c2, c3, c4 },
 #endif
 
+static const uint8_t font[][FONT_WIDTH] = {
+	FONT_GLYPHS
+};
+
 #endif /* LCD_H_ */
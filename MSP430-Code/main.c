@@ -21,74 +21,183 @@
 #define RE_B BIT5  // P2.5
 
 // Constants
-#define ADC_CONVS   4
-#define AVG_TIMES   10
 #define ADC_VISENSE 2
 #define ADC_SENSOR  0
 
-// Timers.
-#define TEMP_SAVE_TIMEOUT_CYCLES  180  // ~6 seconds.
-#define LONG_PRESS_TIMEOUT_CYCLES 50   // ~2 seconds.
+// ADC readings.
+#define ADC_RING_SIZE (2 * ADC_BLOCK_SEQS * ADC_CONVS)
+
+// Heater bar.
+#define BAR_FIRST  2
+#define BAR_LAST   (PCD8544_WIDTH - 2)
+#define BAR_SCALE  (((PCD8544_WIDTH + 1) * 256UL) / PWM_PERIOD)  // Columns per PWM count (x256).
+#define BAR_FULL   0b10111101
+#define BAR_EMPTY  0b10000001
+#define BAR_REDRAW 0xFF
+
+// Rows that are only sent to the display when what's on them changes, unless
+// they are marked as dirty. (one bit per row)
+#define ROW_INFO   (1 << 0)
+#define ROW_ACTUAL (1 << 3)
+#define ROW_ETA    (1 << 4)
+#define ROWS_ALL   0xFF
+
+// Actual temperature shown while the iron is disconnected.
+#define SHOWN_OPEN -1
+
+// Boost kicks in when the iron is this far below the new setpoint.
+#define BOOST_MIN_ERROR 15  // ADC counts. (about 10C)
+
+// Idle detection.
+#define IDLE_MINUTE_CYCLES (60U * RENDER_RATE_HZ)
+#define IDLE_LOAD_DROP     6  // ADC counts below the setpoint while soldering. (about 4C)
+#define IDLE_SETTLED       2  // ADC counts from the setpoint to be considered there.
+
+// Idle states.
+#define IDLE_ACTIVE  0
+#define IDLE_STANDBY 1
+
+// Time for the ADC to get a new reading after being turned back on.
+#define ADC_WAKE_MS 5
+
+// About screen animation.
+#define ABOUT_FRAME_MS 18  // Time between each column of the animation.
+
+// Timers. (in UI render cycles)
+#define TEMP_SAVE_TIMEOUT_CYCLES  (6 * RENDER_RATE_HZ)  // 6 seconds.
+#define LONG_PRESS_TIMEOUT_CYCLES (2 * RENDER_RATE_HZ)  // 2 seconds.
 
 #include <msp430g2553.h>
 #include <stdint.h>
 #include <stdbool.h>
-#include <stdio.h>
 #include <string.h>
 
 #include "delay.h"
 #include "eeprom.h"
 #include "settings.h"
 #include "lcd.h"
+#include "format.h"
+#include "timer.h"
+#include "heater.h"
+#include "pid.h"
+#include "autotune.h"
+#include "estimator.h"
+#include "sense.h"
 #include "screens.h"
 #include "menu.h"
 
+// The calibration confirm screen has two points per row, between the title
+// and the OK.
+#if (CAL_POINTS > 8)
+#error "The calibration confirm screen only fits 8 points."
+#endif
+
 // Global variables.
 int set_temp_val = 0;
 unsigned int set_temp = 0;
-unsigned int actual_temp = 0;
-unsigned int heater_pwm = 0;
-char str[15];  // LCD max char = 14 (+ \0)
+volatile unsigned int actual_temp = 0;
+volatile unsigned int heater_pwm = 0;
+volatile unsigned int heater_duty = 0;
+volatile unsigned int heater_power_avail = 0;
+bool heater_unsafe = false;
+uint8_t sense_run = 0;
 int counter = 0;
 uint8_t last_RE_A = 0;
 bool temp_changed = false;
 int meas_temp = 0;
-int cal_temp[2] = { -1, -1 };
+uint8_t cal_step = 0;
+int cal_temp[CAL_POINTS];
 bool defaults_loaded = false;
 float adc_res = -1;
+unsigned int vin_nominal = 0;
+unsigned int heater_power_limit = 0;
+volatile unsigned int boost_timeout = 0;
+volatile uint8_t idle_state = IDLE_ACTIVE;
+volatile bool idle_activity = false;
+volatile bool wake_requested = false;
+bool idle_settled = false;
+unsigned int idle_cycles = 0;
 unsigned int adc[ADC_CONVS];
+unsigned int adc_ring[ADC_RING_SIZE];
+unsigned int adc_sum[2] = { 0, 0 };
+uint8_t adc_blocks = 0;
+uint8_t adc_order = SENSE_MIN_ORDER;
+unsigned int adc_jitter = 0;
+unsigned int reading_jitter = 0;
+uint8_t reading_order = SENSE_MIN_ORDER;
+volatile bool adc_fresh = false;
+volatile bool adc_tainted = false;
 unsigned int temp_save_timeout = 0;
 unsigned int long_press_timeout = 0;
 int8_t current_preset = -1;
+bool logo_inverted = false;
+uint8_t logo_column = 0;
+bool autotune_shown = false;
+bool diagnostics_heating = false;
+uint8_t bar_level = BAR_REDRAW;
+uint8_t rows_dirty = ROWS_ALL;
+int shown_power = 0;
+int shown_vin = 0;
+bool shown_boost = false;
+int shown_temp = 0;
+unsigned int shown_eta = 0;
+unsigned int last_render = 0;
 
 // Don't stare at it.
-char portastation_line[84] = {
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-	0x00, 0xfe, 0x90, 0x90, 0x90, 0x60,
-	0x00, 0x1c, 0x22, 0x22, 0x22, 0x1c,
-	0x00, 0x3e, 0x10, 0x20, 0x20, 0x10,
-	0x00, 0x20, 0xfc, 0x22, 0x02, 0x04,
-	0x00, 0x04, 0x2a, 0x2a, 0x2a, 0x1e,
-	0x00, 0x62, 0x92, 0x92, 0x92, 0x8c,
-	0x00, 0x20, 0xfc, 0x22, 0x02, 0x04,
-	0x00, 0x04, 0x2a, 0x2a, 0x2a, 0x1e,
-	0x00, 0x20, 0xfc, 0x22, 0x02, 0x04,
-	0x00, 0x00, 0x22, 0xbe, 0x02, 0x00,
-	0x00, 0x1c, 0x22, 0x22, 0x22, 0x1c,
-	0x00, 0x3e, 0x10, 0x20, 0x20, 0x1e,
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+const uint8_t portastation_line[84] = {
+	LCD_COLUMN(0x00), LCD_COLUMN(0x00), LCD_COLUMN(0x00), LCD_COLUMN(0x00),
+	LCD_COLUMN(0x00), LCD_COLUMN(0x00), LCD_COLUMN(0x00), LCD_COLUMN(0x7f),
+	LCD_COLUMN(0x09), LCD_COLUMN(0x09), LCD_COLUMN(0x09), LCD_COLUMN(0x06),
+	LCD_COLUMN(0x00), LCD_COLUMN(0x38), LCD_COLUMN(0x44), LCD_COLUMN(0x44),
+	LCD_COLUMN(0x44), LCD_COLUMN(0x38), LCD_COLUMN(0x00), LCD_COLUMN(0x7c),
+	LCD_COLUMN(0x08), LCD_COLUMN(0x04), LCD_COLUMN(0x04), LCD_COLUMN(0x08),
+	LCD_COLUMN(0x00), LCD_COLUMN(0x04), LCD_COLUMN(0x3f), LCD_COLUMN(0x44),
+	LCD_COLUMN(0x40), LCD_COLUMN(0x20), LCD_COLUMN(0x00), LCD_COLUMN(0x20),
+	LCD_COLUMN(0x54), LCD_COLUMN(0x54), LCD_COLUMN(0x54), LCD_COLUMN(0x78),
+	LCD_COLUMN(0x00), LCD_COLUMN(0x46), LCD_COLUMN(0x49), LCD_COLUMN(0x49),
+	LCD_COLUMN(0x49), LCD_COLUMN(0x31), LCD_COLUMN(0x00), LCD_COLUMN(0x04),
+	LCD_COLUMN(0x3f), LCD_COLUMN(0x44), LCD_COLUMN(0x40), LCD_COLUMN(0x20),
+	LCD_COLUMN(0x00), LCD_COLUMN(0x20), LCD_COLUMN(0x54), LCD_COLUMN(0x54),
+	LCD_COLUMN(0x54), LCD_COLUMN(0x78), LCD_COLUMN(0x00), LCD_COLUMN(0x04),
+	LCD_COLUMN(0x3f), LCD_COLUMN(0x44), LCD_COLUMN(0x40), LCD_COLUMN(0x20),
+	LCD_COLUMN(0x00), LCD_COLUMN(0x00), LCD_COLUMN(0x44), LCD_COLUMN(0x7d),
+	LCD_COLUMN(0x40), LCD_COLUMN(0x00), LCD_COLUMN(0x00), LCD_COLUMN(0x38),
+	LCD_COLUMN(0x44), LCD_COLUMN(0x44), LCD_COLUMN(0x44), LCD_COLUMN(0x38),
+	LCD_COLUMN(0x00), LCD_COLUMN(0x7c), LCD_COLUMN(0x08), LCD_COLUMN(0x04),
+	LCD_COLUMN(0x04), LCD_COLUMN(0x78), LCD_COLUMN(0x00), LCD_COLUMN(0x00),
+	LCD_COLUMN(0x00), LCD_COLUMN(0x00), LCD_COLUMN(0x00), LCD_COLUMN(0x00)
 };
 
 // Function prototypes.
-void read_adc();
 float grab_input_voltage();
 void control_heater();
+void control_heater(const bool on);
+void control_tick();
+unsigned int heater_max_duty();
+unsigned int heater_max_power(const unsigned int max_duty);
+unsigned int heater_max_power();
+void set_heater_power(const unsigned int power);
+void update_power_limit();
+void start_boost();
+unsigned int heater_setpoint();
+void idle_watch_load();
+void idle_update();
+void deep_sleep();
 void set_temperature(int temp, const bool print, const uint8_t unit, const bool force);
 void set_temperature(int temp, const bool print, const uint8_t unit);
 void set_temperature(int temp, const bool print);
 void set_adc_temperature(int temp, const bool print, const uint8_t unit);
 void heater_bar();
+void heater_bar_span(const uint8_t first, const uint8_t last, const uint8_t data);
+void print_set_temperature(const uint8_t unit);
+void print_actual_temperature();
+void print_eta();
 void info_panel();
+void autotune_panel();
+void confirm_cal_panel();
+void diagnostics_panel();
+void diagnostics_heater(const bool on);
+void adc_read_block(const unsigned int *block);
 
 /**
  * Main stuff.
@@ -125,18 +234,27 @@ int main() {
 	eeprom_setup();
 
 	// Configure ADCs.
-	ADC10CTL1 = INCH_3 + CONSEQ_1;        // Selects A3 to A0 and a single sequence.
-	ADC10CTL0 = SREF_0 + ADC10SHT_3 +     // Supply as reference, Sample and Hold 2.
-	            MSC + ADC10ON + ADC10IE;  // Multiple samples, ADC on, ADC interrupt enable.
-	ADC10AE0  = SENSOR + VISENSE;         // ADC input enable.
-	ADC10DTC1 = ADC_CONVS;                // 4 conversions.
+	ADC10CTL1 = INCH_3 + SHS_3 + CONSEQ_3 + // Selects A3 to A0, TA0.2 trigger and repeated sequences.
+	            ADC10SSEL_3 + ADC10DIV_3;   // SMCLK/4, so the sample time is known.
+	ADC10CTL0 = SREF_0 + ADC10SHT_1 +       // Supply as reference, Sample and Hold 8.
+	            ADC10ON + ADC10IE;          // ADC on, ADC interrupt enable.
+	ADC10AE0  = SENSOR + VISENSE;           // ADC input enable.
+	ADC10DTC0 = ADC10TB + ADC10CT;          // Two-block mode, continuous transfers.
+	ADC10DTC1 = ADC_BLOCK_SEQS * ADC_CONVS; // Conversions in each block.
+	ADC10SA   = (uintptr_t)adc_ring;        // Data buffer start.
+	ADC10CTL0 |= ENC;                       // Wait for the triggers.
 
 	// Configure PWM.
-	TA0CCR0  = 500 - 1;          // PWM Period.
+	TA0CCR0  = PWM_PERIOD - 1;   // PWM Period.
 	TA0CCTL1 = OUTMOD_3;         // CCR1 set/reset.
 	TA0CCR1  = 0;                // CCR1 PWM duty cycle.
+	TA0CCTL2 = OUTMOD_3;         // CCR2 set/reset. (ADC trigger)
+	TA0CCR2  = ADC_TRIGGER;      // CCR2 ADC trigger point.
 	TA0CTL   = TASSEL_2 + MC_1;  // SMCLK, up mode.
 
+	// Configure the system tick.
+	timer_setup();
+
 	// Configure Port 1 interrupts.
 	P1IE  |= (SWITCH);   // Enabled interrupts for SWITCH.
 	P1IES |= (SWITCH);   // SWITCH set for a HIGH to LOW transition.
@@ -178,7 +296,9 @@ int main() {
 
 				load_settings();
 				adc_res = settings.vref / 1023.0;
-				delay_ms(1000);
+				vin_nominal = (unsigned int)((PID_VIN_NOMINAL * settings.vin_ratio) / adc_res);
+				lcd_flush();
+				timer_delay(1000);
 				break;
 			case MAIN_SCREEN:
 				// If it's time to save, then save this shit. I had to do this
@@ -188,6 +308,11 @@ int main() {
 					save_next_time = false;
 				}
 
+				// Someone is clearly using it.
+				idle_state = IDLE_ACTIVE;
+				idle_cycles = 0;
+				idle_settled = false;
+
 				// Set the initial temperature and reset the save timer.
 				set_temperature(conv_adc_temp(settings.last_set_temp + 1), true,
 						settings.temp_unit, true);
@@ -204,31 +329,52 @@ int main() {
 				lcd_print(" Calibration  ", INVERTED);
 				lcd_set_pos(0, 1);
 				lcd_putc(' ');
+
+				// Start from the first point.
+				cal_step = 0;
 				break;
 			case CONFIRM_CAL_SCREEN:
 				// Confirm the calibration screen title.
 				lcd_set_pos(0, 0);
 				lcd_print("  Calibrated  ", INVERTED);
 
-				// Printing parameters.
-				snprintf(str, sizeof(str), "P1: (%d, %d) ", CAL_LOW_TEMP_ADC, cal_temp[0]);
+				confirm_cal_panel();
+				break;
+			case AUTOTUNE_SCREEN:
+				// Autotune screen title.
+				lcd_set_pos(0, 0);
+				lcd_print(" PID Autotune ", INVERTED);
+
+				// Oscillate around the temperature the user works with.
 				lcd_set_pos(0, 1);
-				lcd_print(str);
-				snprintf(str, sizeof(str), "P2: (%d, %d) ", CAL_HIGH_TEMP_ADC, cal_temp[1]);
-				lcd_set_pos(0, 2);
-				lcd_print(str);
-
-				// Printing OK.
-				lcd_set_pos(0, 5);
-				lcd_print("     ");
-				lcd_print(" OK ", INVERTED);
+				lcd_print("Target:");
+				print_int(conv_adc_temp(settings.last_set_temp), 5);
+				lcd_print(settings.temp_unit_symbol);
+
+				autotune_start(settings.last_set_temp);
+				autotune_shown = false;
+				break;
+			case DIAGNOSTICS_SCREEN:
+				// The heater stays off until someone turns it on.
+				diagnostics_heater(false);
 				break;
 			case ABOUT_SCREEN:
 				about_screen();
+
+				// Start the animation by inverting the logo.
+				logo_inverted = true;
+				logo_column = 0;
 				break;
 			}
 
 			counter = 0;
+			bar_level = BAR_REDRAW;
+			rows_dirty = ROWS_ALL;
+			update_power_limit();        // The settings might have changed.
+			pid_reset(adc[ADC_SENSOR]);  // The heater was turned off.
+			estimator_reset(adc[ADC_SENSOR]);
+			sense_reset();
+			sense_filter_reset(adc[ADC_SENSOR]);
 			screen_setup = false;
 		}
 
@@ -241,6 +387,19 @@ int main() {
 			// Set the new temperature.
 			set_temperature(set_temp_val + counter, true);
 
+			// The rest is UI stuff, which doesn't need to run that often.
+			if (!timer_elapsed(&last_render, RENDER_PERIOD_MS)) {
+				break;
+			}
+
+			render_count++;
+
+			// Go to standby or to sleep if nobody is using it.
+			idle_update();
+			if (screen_setup) {
+				break;
+			}
+
 			// Save set temperature timeout.
 			if (temp_save_timeout > 0) {
 				temp_save_timeout--;
@@ -278,32 +437,9 @@ int main() {
 				}
 			}
 
-			// Read ADC and do stuff with the measured values.
-			read_adc();
-			actual_temp = adc[ADC_SENSOR];
-			control_heater();
 			info_panel();
-
-			// Check if the soldering iron is connected.
-			lcd_set_pos(0, 3);
-			if (actual_temp >= 1023) {
-				// Soldering iron disconnected.
-				lcd_print(" Disconnected ", INVERTED);
-			} else {
-				// Printing actual temperature.
-				int ac_temp = conv_adc_temp(actual_temp);
-
-				// Prevent non-linear values of temperature from being shown.
-				if (ac_temp < 99) {
-					snprintf(str, sizeof(str), "Actual:  <99%s ",
-							settings.temp_unit_symbol);
-					lcd_print(str);
-				} else {
-					snprintf(str, sizeof(str), "Actual:  %d%s ", ac_temp,
-							settings.temp_unit_symbol);
-					lcd_print(str);
-				}
-			}
+			print_actual_temperature();
+			print_eta();
 
 			// Heater bar!
 			heater_bar();
@@ -323,79 +459,442 @@ int main() {
 			break;
 		case CALIBRATION_SCREEN:
 			// Set the temperature.
-			if (cal_temp[0] == -1) {
-				set_adc_temperature(CAL_LOW_TEMP_ADC, false, CELSIUS);
-			} else {
-				set_adc_temperature(CAL_HIGH_TEMP_ADC, false, CELSIUS);
-			}
-
-			// Measure the temperature, and do all the control stuff.
-			read_adc();
-			actual_temp = adc[ADC_SENSOR];
-			control_heater();
+			set_adc_temperature(CAL_POINT_ADC(cal_step), false, CELSIUS);
 
 			if (temp_changed) {
 				// Printing the ADC setpoint.
-				snprintf(str, sizeof(str), "Setpoint: %d  ", set_temp);
 				lcd_set_pos(0, 1);
-				lcd_print(str);
+				lcd_print("Setpoint:");
+				print_int(set_temp, 5);
+
+				// Printing which point this is.
+				lcd_set_pos(0, 3);
+				lcd_print("Point:");
+				print_int(cal_step + 1, 6);
+				lcd_putc('/');
+				print_int(CAL_POINTS);
 
 				meas_temp = set_temp_val;
 			}
 
+			// The rest is UI stuff, which doesn't need to run that often.
+			if (!timer_elapsed(&last_render, RENDER_PERIOD_MS)) {
+				break;
+			}
+
+			render_count++;
+
 			// Printing actual sensed ADC temperature.
-			snprintf(str, sizeof(str), "Sense:    %d ", actual_temp);
 			lcd_set_pos(0, 2);
-			lcd_print(str);
+			lcd_print("Sense:");
+			print_int(SENSE_COARSE(sense_display_temp()), 8);
 
 			// Changing the measured temperature.
 			meas_temp += counter;
 			counter = 0;
 
 			// Printing measured temperature.
-			snprintf(str, sizeof(str), "Meas.:   %d  ", meas_temp);
 			lcd_set_pos(0, 4);
-			lcd_print(str);
+			lcd_print("Meas.:");
+			print_int(meas_temp, 6);
 			lcd_putc(0x7f);
 			lcd_putc('C');
 
 			// Heater bar!
 			heater_bar();
 			break;
+		case AUTOTUNE_SCREEN:
+			// The relay experiment runs in the control loop, but the gains are
+			// worked out here since it takes a while.
+			if (autotune_state == AUTOTUNE_MEASURED) {
+				autotune_finish();
+			}
+
+			// Just show the results once it's done.
+			if (autotune_state != AUTOTUNE_RUNNING) {
+				if (!autotune_shown) {
+					autotune_panel();
+					autotune_shown = true;
+				}
+
+				break;
+			}
+
+			// Progress doesn't need to be updated that often.
+			if (!timer_elapsed(&last_render, RENDER_PERIOD_MS)) {
+				break;
+			}
+
+			render_count++;
+
+			// Show how far along we are.
+			lcd_set_pos(0, 2);
+			if (autotune_cycle == 0) {
+				lcd_print("Heating up    ");
+			} else {
+				lcd_print("Cycle:");
+				print_int(autotune_cycle, 5);
+				lcd_putc('/');
+				print_int(AUTOTUNE_SKIP_CYCLES + AUTOTUNE_CYCLES, 2);
+			}
+
+			print_actual_temperature();
+			heater_bar();
+			break;
+		case DIAGNOSTICS_SCREEN:
+			// Turning the knob right turns the heater on, left turns it off.
+			if (counter != 0) {
+				diagnostics_heater(counter > 0);
+				counter = 0;
+			}
+
+			// Numbers don't need to be updated that often.
+			if (!timer_elapsed(&last_render, RENDER_PERIOD_MS)) {
+				break;
+			}
+
+			render_count++;
+
+			diagnostics_panel();
+			break;
+		case SLEEP_SCREEN:
+			deep_sleep();
+			break;
 		case ABOUT_SCREEN:
-			// Awesome scrolling inverter animation.
-			for (uint8_t i = 0; i < 84; i++) {
-				portastation_line[i] = ~portastation_line[i];
+			// Nothing to do until it's time for the next frame.
+			if (!timer_elapsed(&last_render, ABOUT_FRAME_MS)) {
+				break;
+			}
+
+			// Awesome scrolling inverter animation, one column per frame.
+			lcd_set_pos(logo_column, 3);
+			if (logo_inverted) {
+				lcd_command(0, ~portastation_line[logo_column]);
+			} else {
+				lcd_command(0, portastation_line[logo_column]);
+			}
 
-				lcd_set_pos(i, 3);
-				lcd_command(0, portastation_line[i]);
-				delay_ms(18);
+			// Go back to the start and invert it again.
+			if (++logo_column >= PCD8544_WIDTH) {
+				logo_column = 0;
+				logo_inverted = !logo_inverted;
 			}
 			break;
 		}
+
+		// Let the display catch up in the background and sleep until the next
+		// tick.
+		lcd_flush_async();
+		timer_sleep();
 	}
 
 	return 0;
 }
 
 /**
- * Heater control feedback loop.
+ * Heater control loop, runs from the system tick every CONTROL_PERIOD_MS with
+ * the latest temperature reading.
+ */
+void control_tick() {
+	// Count down the boost time.
+	if (boost_timeout > 0) {
+		boost_timeout--;
+	}
+
+	// Leave the heater alone while the screen is changing.
+	if (screen_setup) {
+		return;
+	}
+
+	// The supply only has to be worked out once per tick, it takes a couple of
+	// long divisions.
+	pid_set_supply(adc[ADC_VISENSE], vin_nominal);
+
+	switch (current_screen) {
+	case MAIN_SCREEN:
+	case CALIBRATION_SCREEN:
+		control_heater();
+		idle_watch_load();
+		control_count++;
+		break;
+	case DIAGNOSTICS_SCREEN:
+		// The sensor is read just the same with the heater off.
+		control_heater(diagnostics_heating);
+		control_count++;
+		break;
+	case AUTOTUNE_SCREEN:
+		if (adc_fresh) {
+			adc_fresh = false;
+			sense_filter(adc[ADC_SENSOR]);
+			actual_temp = sense_control_temp();
+		}
+
+		// Relay experiment, turning the heater off as soon as it's over.
+		if (autotune_state == AUTOTUNE_RUNNING) {
+			set_heater_power(autotune_update(SENSE_COARSE(actual_temp), heater_max_power()));
+			control_count++;
+		} else {
+			set_heater_power(0);
+		}
+		break;
+	}
+}
+
+/**
+ * Heater control feedback loop with the heater on.
  */
 void control_heater() {
+	control_heater(true);
+}
+
+/**
+ * Heater control feedback loop. It runs on the estimated temperature, so that
+ * while heating up or recovering from a load the heater can take the whole
+ * period instead of turning off for a reading every time.
+ *
+ * @param on Should the heater be on? If not the readings keep coming in, but
+ *           the heater is kept off and the controller reset.
+ */
+void control_heater(const bool on) {
+	unsigned int power;
+	bool sense;
+
+	// Predict where the last period took the iron and fold in a new reading.
+	estimator_update(heater_pwm);
+	if (adc_fresh) {
+		adc_fresh = false;
+		sense_filter(adc[ADC_SENSOR]);
+		actual_temp = sense_control_temp();
+		estimator_correct(actual_temp);
+		sense_add_reading(reading_jitter, reading_order);
+	}
+
+	// Quick readings while it's on the move, clean ones once it's there.
+	sense_budget(SENSE_FINE(heater_setpoint()), estimator_temp());
+
+	// Make room for a reading if the model asks for one.
+	if (sense_run > 0) {
+		sense_run--;
+		sense = true;
+	} else if (estimator_needs_reading()) {
+		sense_run = sense_run_periods() - 1;
+		sense = true;
+	} else {
+		sense = false;
+	}
+
 	// Feedback loop.
-	if (actual_temp < set_temp) {
-		if (heater_pwm < 500) {
-			heater_pwm += 10;
+	heater_power_avail = heater_max_power(PWM_PERIOD);
+	if (!on) {
+		pid_reset(estimator_temp());
+		set_heater_power(0);
+		return;
+	}
+
+	power = pid_update(SENSE_FINE(heater_setpoint()), estimator_temp(),
+			sense ? heater_max_power(heater_max_duty()) : heater_power_avail,
+			heater_power_avail);
+
+	set_heater_power(power);
+}
+
+/**
+ * Gets the temperature the heater should be at right now, which is lower than
+ * the one that was set while in standby.
+ *
+ * @return Target temperature in ADC counts.
+ */
+unsigned int heater_setpoint() {
+	if ((idle_state == IDLE_STANDBY) && (settings.standby_temp < set_temp)) {
+		return settings.standby_temp;
+	}
+
+	return set_temp;
+}
+
+/**
+ * Looks for the iron dipping below the setpoint, which is what happens when
+ * it's soldering something, and counts it as someone using it.
+ */
+void idle_watch_load() {
+	unsigned int target = SENSE_FINE(heater_setpoint());
+
+	if ((actual_temp + SENSE_FINE(IDLE_LOAD_DROP)) < target) {
+		// Only a dip after it got there, heating up doesn't count.
+		if (idle_settled) {
+			idle_settled = false;
+			idle_activity = true;
 		}
-	} else if (actual_temp >= set_temp) {
-		if (heater_pwm > 100) {
-			heater_pwm -= 100;
-		} else {
-			heater_pwm = 0;
+	} else if ((actual_temp + SENSE_FINE(IDLE_SETTLED)) >= target) {
+		idle_settled = true;
+	}
+}
+
+/**
+ * Keeps track of how long it's been since anyone used the iron, dropping it to
+ * the standby temperature and then putting everything to sleep. Should be
+ * called every UI render cycle.
+ */
+void idle_update() {
+	// Someone is using it, so get back to work as fast as possible.
+	if (idle_activity) {
+		idle_activity = false;
+		idle_cycles = 0;
+
+		if (idle_state == IDLE_STANDBY) {
+			idle_state = IDLE_ACTIVE;
+			print_set_temperature(settings.temp_unit);
+			start_boost();
 		}
+
+		return;
 	}
 
-	TA0CCR1 = heater_pwm;
+	idle_cycles++;
+	switch (idle_state) {
+	case IDLE_ACTIVE:
+		if (settings.standby_time > 0) {
+			if (idle_cycles >= (settings.standby_time * IDLE_MINUTE_CYCLES)) {
+				idle_state = IDLE_STANDBY;
+				idle_cycles = 0;
+				print_set_temperature(settings.temp_unit);
+			}
+		} else if ((settings.sleep_time > 0) &&
+				(idle_cycles >= (settings.sleep_time * IDLE_MINUTE_CYCLES))) {
+			// No standby, straight to sleep.
+			change_screen(SLEEP_SCREEN);
+		}
+		break;
+	case IDLE_STANDBY:
+		if ((settings.sleep_time > 0) &&
+				(idle_cycles >= (settings.sleep_time * IDLE_MINUTE_CYCLES))) {
+			change_screen(SLEEP_SCREEN);
+		}
+		break;
+	}
+}
+
+/**
+ * Turns everything off and sleeps in LPM3 until the button or the encoder
+ * wakes us up, then goes back to the main screen.
+ */
+void deep_sleep() {
+	// The PWM and the ADC run from SMCLK, which is about to stop, so give the
+	// heater pin back to the port (which keeps it off) and turn the ADC off.
+	P1SEL &= ~HEATER;
+	ADC10CTL0 &= ~ENC;
+	ADC10CTL0 &= ~ADC10ON;
+	lcd_powerdown();
+
+	// Sleep, unless someone already touched it.
+	__disable_interrupt();
+	if (!wake_requested) {
+		__bis_SR_register(LPM3_bits + GIE);
+	}
+	__enable_interrupt();
+	wake_requested = false;
+
+	// Bring everything back, restarting the ADC transfers from the beginning
+	// with a quick reading.
+	adc_sum[0] = 0;
+	adc_sum[1] = 0;
+	adc_jitter = 0;
+	adc_blocks = 0;
+	adc_order = SENSE_MIN_ORDER;
+	ADC10SA = (uintptr_t)adc_ring;
+	ADC10CTL0 |= ADC10ON;
+	ADC10CTL0 |= ENC;
+	P1SEL |= HEATER;
+	lcd_powerup();
+
+	// Get a reading of the cold iron, so that it boosts back up.
+	timer_delay(ADC_WAKE_MS);
+	sense_filter_reset(adc[ADC_SENSOR]);
+	actual_temp = sense_control_temp();
+	start_boost();
+	change_screen(MAIN_SCREEN);
+}
+
+/**
+ * Sends a power level to the heater, compensating for the supply voltage.
+ *
+ * @param power Power, in duty cycle at the nominal supply voltage.
+ */
+void set_heater_power(const unsigned int power) {
+	heater_pwm = power;
+	heater_duty = pid_dither_duty(power);
+
+	TA0CCR1 = heater_duty;
+
+	// The readings taken while the heater is on in the sense window are no good.
+	heater_unsafe = heater_duty > heater_max_duty();
+	if (heater_unsafe) {
+		adc_tainted = true;
+	}
+}
+
+/**
+ * Gets the most power that can be delivered with the current supply voltage
+ * while still leaving room for the readings. The supply has to have been set
+ * already in this tick.
+ *
+ * @return Maximum power, in duty cycle at the nominal supply voltage.
+ */
+unsigned int heater_max_power() {
+	return heater_max_power(heater_max_duty());
+}
+
+/**
+ * Gets the most power that can be delivered with the current supply voltage.
+ * The supply has to have been set already in this tick.
+ *
+ * @param max_duty Largest duty cycle that can be used.
+ * @return Maximum power, in duty cycle at the nominal supply voltage.
+ */
+unsigned int heater_max_power(const unsigned int max_duty) {
+	unsigned int max = pid_max_power(max_duty);
+
+	// Stay under the power ceiling, unless we're boosting.
+	if ((boost_timeout == 0) && (max > heater_power_limit)) {
+		max = heater_power_limit;
+	}
+
+	return max;
+}
+
+/**
+ * Converts the power ceiling from the settings into the controller's units,
+ * the duty cycle that would deliver it at the nominal supply voltage.
+ */
+void update_power_limit() {
+	heater_power_limit = (unsigned int)((settings.max_watts * settings.rheater * PWM_PERIOD) /
+			(PID_VIN_NOMINAL * PID_VIN_NOMINAL));
+}
+
+/**
+ * Allows the heater to go over the power ceiling for a while, as long as the
+ * iron is well below the setpoint.
+ */
+void start_boost() {
+	unsigned int measured = SENSE_COARSE(actual_temp);
+
+	if ((set_temp > measured) && ((set_temp - measured) > BOOST_MIN_ERROR)) {
+		boost_timeout = settings.boost_time * CONTROL_RATE_HZ;
+	}
+}
+
+/**
+ * Gets the largest duty cycle that can be sent to the heater.
+ *
+ * @return Maximum duty cycle.
+ */
+unsigned int heater_max_duty() {
+	// Keep the heater off while the sensor is being sampled if needed.
+	if (settings.sense_when_off) {
+		return SENSE_MAX_DUTY;
+	}
+
+	return PWM_PERIOD;
 }
 
 /**
@@ -428,6 +927,8 @@ void set_temperature(int temp, const bool print, const uint8_t unit) {
  * @param force Forces the change.
  */
 void set_temperature(int temp, const bool print, const uint8_t unit, const bool force) {
+	unsigned int last = set_temp;
+
 	if ((temp != set_temp_val) || force) {
 		// Perform the important calculations.
 		set_temp = conv_temp_adc(temp, unit);
@@ -446,20 +947,17 @@ void set_temperature(int temp, const bool print, const uint8_t unit, const bool
 		}
 
 		if (print) {
-			char str_unit[3];
-			str_unit[0] = settings.temp_unit_symbol[0];
-			str_unit[1] = get_temp_unit(unit);
-			str_unit[2] = settings.temp_unit_symbol[2];
-
-			// Print the new set temperature.
-			snprintf(str, sizeof(str), "Set:     %d%s ", set_temp_val, str_unit);
-			lcd_set_pos(0, 2);
-			lcd_print(str);
+			print_set_temperature(unit);
 		}
 
 		// Set the save timeout timer and the changed temperature flag.
 		temp_save_timeout = TEMP_SAVE_TIMEOUT_CYCLES;
 		temp_changed = true;
+
+		// Get there as fast as the supply allows, but only when it went up.
+		if (set_temp > last) {
+			start_boost();
+		}
 	} else {
 		temp_changed = false;
 	}
@@ -473,7 +971,9 @@ void set_temperature(int temp, const bool print, const uint8_t unit, const bool
  * @param unit Desired unit to be used.
  */
 void set_adc_temperature(int temp, const bool print, const uint8_t unit) {
-	if (temp != set_temp) {
+	unsigned int last = set_temp;
+
+	if ((unsigned int)temp != set_temp) {
 		// Perform the important calculations.
 		set_temp = temp;
 
@@ -482,20 +982,16 @@ void set_adc_temperature(int temp, const bool print, const uint8_t unit) {
 		set_temp_val = conv_adc_temp(temp, unit);
 
 		if (print) {
-			char str_unit[3];
-			str_unit[0] = settings.temp_unit_symbol[0];
-			str_unit[1] = get_temp_unit(unit);
-			str_unit[2] = settings.temp_unit_symbol[2];
-
-			// Print the new set temperature.
-			snprintf(str, sizeof(str), "Set:     %d%s ", set_temp_val, str_unit);
-			lcd_set_pos(0, 2);
-			lcd_print(str);
+			print_set_temperature(unit);
 		}
 
-		// Set the save timeout timer if in the main screen.
+		// Set the save timeout timer and boost if it went up in the main screen.
 		if (current_screen == MAIN_SCREEN) {
 			temp_save_timeout = TEMP_SAVE_TIMEOUT_CYCLES;
+
+			if (set_temp > last) {
+				start_boost();
+			}
 		}
 
 		temp_changed = true;
@@ -505,66 +1001,270 @@ void set_adc_temperature(int temp, const bool print, const uint8_t unit) {
 }
 
 /**
- * Prints the information panel at the top of the screen.
+ * Prints the set temperature line.
+ *
+ * @param unit Unit of the set temperature.
  */
-void info_panel() {
-	uint8_t int_len = 0;
+void print_set_temperature(const uint8_t unit) {
+	char str_unit[3];
+	str_unit[0] = settings.temp_unit_symbol[0];
+	str_unit[1] = get_temp_unit(unit);
+	str_unit[2] = settings.temp_unit_symbol[2];
+
+	lcd_set_pos(0, 2);
+	if (idle_state == IDLE_STANDBY) {
+		// Show what it's actually holding while nobody is using it.
+		lcd_print("Stby:");
+		print_int(conv_adc_temp(heater_setpoint(), unit), 7);
+	} else {
+		lcd_print("Set:");
+		print_int(set_temp_val, 8);
+	}
+	lcd_print(str_unit);
+}
 
-	// Slice the input voltage float. https://stackoverflow.com/a/40401141/126353
-	float vin = grab_input_voltage();
-	unsigned int vin_dec = (unsigned int)(vin * 10) % 10;
+/**
+ * Prints the actual temperature line if it changed.
+ */
+void print_actual_temperature() {
+	unsigned int shown = sense_display_temp();
+	int ac_temp = SHOWN_OPEN;
+
+	// Prevent non-linear values of temperature from being shown.
+	if (shown < SENSE_OPEN) {
+		ac_temp = conv_fine_adc_temp(shown);
+		if (ac_temp < 99) {
+			ac_temp = 98;
+		}
+	}
+
+	if (!(rows_dirty & ROW_ACTUAL) && (ac_temp == shown_temp)) {
+		return;
+	}
+	rows_dirty &= ~ROW_ACTUAL;
+	shown_temp = ac_temp;
+
+	// Check if the soldering iron is connected.
+	lcd_set_pos(0, 3);
+	if (ac_temp == SHOWN_OPEN) {
+		// Soldering iron disconnected.
+		lcd_print(" Disconnected ", INVERTED);
+	} else {
+		// Printing actual temperature.
+		lcd_print("Actual:");
+		if (ac_temp < 99) {
+			lcd_print("  <99");
+		} else {
+			print_int(ac_temp, 5);
+		}
+		lcd_print(settings.temp_unit_symbol);
+	}
+}
+
+/**
+ * Prints how long it'll take to get to the setpoint if it changed, clearing
+ * the line once it's there.
+ */
+void print_eta() {
+	unsigned int eta = estimator_eta(SENSE_FINE(heater_setpoint()), heater_power_avail);
+
+	if (!(rows_dirty & ROW_ETA) && (eta == shown_eta)) {
+		return;
+	}
+	rows_dirty &= ~ROW_ETA;
+	shown_eta = eta;
+
+	lcd_set_pos(0, 4);
+	if (eta == 0) {
+		lcd_print("              ");
+		return;
+	}
+
+	lcd_print("Ready in:");
+	if (eta == ESTIMATOR_NEVER) {
+		lcd_print("  --");
+	} else {
+		print_int(eta, 4);
+	}
+	lcd_putc('s');
+}
 
-	// Pad the integer part of the input voltage.
-	char v_int_str[3];
-	int_len = snprintf(v_int_str, sizeof(v_int_str), "%d", (uint8_t)vin);
-	if (int_len < 2) {
-		snprintf(v_int_str, sizeof(v_int_str), "0%d", (uint8_t)vin);
+/**
+ * Prints the information panel at the top of the screen if it changed.
+ */
+void info_panel() {
+	// Input voltage and power in tenths.
+	float vin = grab_input_voltage();
+	float power = (vin * vin * (heater_duty / (float)PWM_PERIOD)) / settings.rheater;
+	int power_tenths = (int)(power * 10);
+	int vin_tenths = (int)(vin * 10);
+	bool boost = boost_timeout > 0;
+
+	if (!(rows_dirty & ROW_INFO) && (power_tenths == shown_power) &&
+			(vin_tenths == shown_vin) && (boost == shown_boost)) {
+		return;
 	}
+	rows_dirty &= ~ROW_INFO;
+	shown_power = power_tenths;
+	shown_vin = vin_tenths;
+	shown_boost = boost;
 
-	// Power calculations and float slicing.
-	float power = (vin * vin * (heater_pwm / 500.0)) / settings.rheater;
-	unsigned int p_dec = (unsigned int)(power * 10) % 10;
+	lcd_set_pos(0, 0);
+	print_fixed(power_tenths, 4, '0');
+	lcd_print("W  ");
 
-	// Pad the integer part of the power.
-	char p_int_str[3];
-	int_len = snprintf(p_int_str, sizeof(p_int_str), "%d", (uint8_t)power);
-	if (int_len < 2) {
-		snprintf(p_int_str, sizeof(p_int_str), "0%d", (uint8_t)power);
+	// Show when the power ceiling is lifted.
+	if (boost) {
+		lcd_putc('B', INVERTED);
+	} else {
+		lcd_putc(' ');
 	}
 
-	snprintf(str, sizeof(str), "%s.%dW    %s.%dV", p_int_str, p_dec, v_int_str, vin_dec);
+	lcd_print(" ");
+	print_fixed(vin_tenths, 4, '0');
+	lcd_putc('V');
+}
+
+/**
+ * Shows how the sensor is being read.
+ */
+void diagnostics_panel() {
+	// Samples in each reading and how many of them got used every second.
+	lcd_set_pos(0, 1);
+	lcd_print("Per read:");
+	print_int(1 << sense_order(), 5);
+	lcd_set_pos(0, 2);
+	lcd_print("Samples/s:");
+	print_int(sample_rate, 4);
+
+	// Variance of a reading and noise of a single sample. (fine counts)
+	lcd_set_pos(0, 3);
+	lcd_print("Var.:");
+	print_fixed((int)(((unsigned long)sense_variance() * 10) >> 8), 9, ' ');
+	lcd_set_pos(0, 4);
+	lcd_print("Noise:");
+	print_fixed((int)((sense_noise() * 10UL) >> 4), 8, ' ');
+
+	// How often the control loop and the screen actually ran. (Hz)
+	lcd_set_pos(0, 5);
+	lcd_print("Ctrl/UI:");
+	print_int(control_rate, 3);
+	lcd_putc('/');
+	print_int(render_rate, 2);
+}
+
+/**
+ * Turns the heater on or off in the diagnostics screen, showing which one it
+ * is in the title.
+ *
+ * @param on Should the heater be on?
+ */
+void diagnostics_heater(const bool on) {
+	diagnostics_heating = on;
+
 	lcd_set_pos(0, 0);
-	lcd_print(str);
+	if (on) {
+		lcd_print("Diag. Heat: On", INVERTED);
+	} else {
+		lcd_print("Diag. Heat:Off", INVERTED);
+	}
 }
 
 /**
- * Sets the size of the heater bar according to the PWM level.
+ * Shows the measured temperature of each calibration point, two per row, with
+ * the OK on the last row.
  */
-void heater_bar() {
-	float val = 0.168 * heater_pwm;
+void confirm_cal_panel() {
+	// The second column starts half way through the row. (7 characters)
+	for (uint8_t i = 0; i < CAL_POINTS; i++) {
+		lcd_set_pos((i & 1) ? (7 * (FONT_WIDTH + 1)) : 0, (i >> 1) + 1);
+		print_int(i + 1);
+		lcd_putc(':');
+		print_int(cal_temp[i], 4);
+	}
 
-#ifndef ROTATION_ENABLE
-	// Set the position.
+	// Printing OK.
 	lcd_set_pos(0, 5);
-#endif
+	lcd_print("     ");
+	lcd_print(" OK ", INVERTED);
+	lcd_print("     ");
+}
+
+/**
+ * Shows the results of the autotune experiment.
+ */
+void autotune_panel() {
+	if (autotune_state == AUTOTUNE_FAILED) {
+		lcd_set_pos(0, 2);
+		lcd_print("    Failed    ", INVERTED);
+	} else {
+		lcd_set_pos(0, 1);
+		lcd_print("Kp:  ");
+		print_int(settings.pid_kp, FORMAT_MAX_WIDTH);
+		lcd_set_pos(0, 2);
+		lcd_print("Ki:  ");
+		print_int(settings.pid_ki, FORMAT_MAX_WIDTH);
+		lcd_set_pos(0, 3);
+		lcd_print("Kd:  ");
+		print_int(settings.pid_kd, FORMAT_MAX_WIDTH);
+	}
 
-	for (uint8_t i = 0; i < PCD8544_WIDTH + 1; i++) {
+	// Printing OK.
+	lcd_set_pos(0, 5);
+	lcd_print("     ");
+	lcd_print(" OK ", INVERTED);
+	lcd_print("     ");
+}
+
+/**
+ * Sets the size of the heater bar according to the PWM level. Only the
+ * columns between the last drawn level and the new one are sent.
+ */
+void heater_bar() {
+	uint8_t level = (heater_duty * BAR_SCALE) >> 8;
+
+	// Keep it inside the frame.
+	if (level < BAR_FIRST - 1) {
+		level = BAR_FIRST - 1;
+	} else if (level > BAR_LAST) {
+		level = BAR_LAST;
+	}
+
+	// Draw the frame and an empty bar.
+	if (bar_level == BAR_REDRAW) {
+		heater_bar_span(0, 0, 0b11111111);
+		heater_bar_span(PCD8544_WIDTH, PCD8544_WIDTH, 0b11111111);
+		heater_bar_span(1, PCD8544_WIDTH - 1, BAR_EMPTY);
+
+		bar_level = BAR_FIRST - 1;
+	}
+
+	// Fill or empty the difference.
+	if (level > bar_level) {
+		heater_bar_span(bar_level + 1, level, BAR_FULL);
+	} else if (level < bar_level) {
+		heater_bar_span(level + 1, bar_level, BAR_EMPTY);
+	}
+
+	bar_level = level;
+}
+
+/**
+ * Fills a span of columns of the heater bar row.
+ *
+ * @param first First column.
+ * @param last Last column.
+ * @param data Column pixels.
+ */
+void heater_bar_span(const uint8_t first, const uint8_t last, const uint8_t data) {
 #ifdef ROTATION_ENABLE
-		// Set the position.
-		lcd_set_pos(i, 5);
+	// Upside down the columns are sent from right to left.
+	lcd_set_pos(last, 5);
+#else
+	lcd_set_pos(first, 5);
 #endif
 
-		// Print the bar.
-		if ((i == 0) || (i == PCD8544_WIDTH)) {
-			lcd_command(0, 0b11111111);
-		} else if ((i == 1) || (i == PCD8544_WIDTH - 1)) {
-			lcd_command(0, 0b10000001);
-		} else if (i <= (int)val) {
-			lcd_command(0, 0b10111101);
-		} else {
-			lcd_command(0, 0b10000001);
-		}
-	}
+	lcd_fill(data, last - first + 1);
 }
 
 /**
@@ -578,41 +1278,61 @@ float grab_input_voltage() {
 }
 
 /**
- * Reads the ADC values into the array.
+ * Adds a block of conversions from the DTC to the reading being taken, and
+ * hands the reading over once it has all the samples in its budget.
+ *
+ * @param block ADC_BLOCK_SEQS sequences of ADC_CONVS conversions each.
  */
-void read_adc() {
-	unsigned int val[2] = { 0, 0 };
-
-	if (settings.sense_when_off) {
-		TA0CCR1 = 0;  // Disable the heater.
-	}
+void adc_read_block(const unsigned int *block) {
+	unsigned int last = 0;
 
-	for (uint8_t i = 0; i < AVG_TIMES; i++) {
-		delay_us(100);  // Wait for ADC reference to settle.
-		ADC10CTL0 &= ~ENC;
-		while (ADC10CTL1 & BUSY);         // Wait until ADC10 core is active.
+	for (uint8_t i = 0; i < ADC_BLOCK_SEQS; i++) {
+		unsigned int sample = block[ADC_SENSOR];
 
-		ADC10SA = (unsigned int)adc;      // Data buffer start.
-		ADC10CTL0 |= ENC + ADC10SC;       // Sampling and conversion start
-		__bis_SR_register(CPUOFF + GIE);  // Enter LPM0 with interrupts enabled.
+		// Noise, from how much each sample jumps from the one before it.
+		if (i > 0) {
+			adc_jitter += (sample > last) ? (sample - last) : (last - sample);
+		}
+		last = sample;
 
-		val[0] += adc[ADC_SENSOR];
-		val[1] += adc[ADC_VISENSE];
+		adc_sum[0] += sample;
+		adc_sum[1] += block[ADC_VISENSE];
+		block += ADC_CONVS;
 	}
 
-	// Get the measured averages and re-enable the heater.
-	adc[ADC_SENSOR] = (unsigned int)(val[0] / AVG_TIMES);
-	adc[ADC_VISENSE] = (unsigned int)(val[1] / AVG_TIMES);
+	// Check if we've got enough for a new reading.
+	if (++adc_blocks < (1 << (adc_order - ADC_BLOCK_ORDER))) {
+		return;
+	}
 
-	if (settings.sense_when_off) {
-		TA0CCR1 = heater_pwm;
+	// Throw it away if the heater was on while sampling at any point.
+	if (!adc_tainted) {
+		adc[ADC_SENSOR] = adc_sum[0] >> (adc_order - SENSE_FRAC_BITS);  // Fine counts.
+		adc[ADC_VISENSE] = adc_sum[1] >> adc_order;
+		reading_jitter = adc_jitter;
+		reading_order = adc_order;
+		adc_fresh = true;
 	}
+
+	// Start the next one with the latest budget.
+	adc_order = sense_order();
+	adc_tainted = heater_unsafe;
+	adc_sum[0] = 0;
+	adc_sum[1] = 0;
+	adc_jitter = 0;
+	adc_blocks = 0;
 }
 
 // ADC10 interrupt service routine.
 #pragma vector=ADC10_VECTOR
 __interrupt void ADC10_ISR(void) {
-	__bic_SR_register_on_exit(CPUOFF);  // Return to active mode.
+	// Grab the block that the DTC just filled, it's already working on the
+	// other one.
+	if (ADC10DTC0 & ADC10B1) {
+		adc_read_block(adc_ring);
+	} else {
+		adc_read_block(adc_ring + (ADC_RING_SIZE / 2));
+	}
 }
 
 // Port 1 interrupt service routine.
@@ -627,36 +1347,53 @@ __interrupt void Port_1(void) {
 		change_screen(SPLASH_SCREEN);
 		break;
 	case MAIN_SCREEN:
-		long_press_timeout = LONG_PRESS_TIMEOUT_CYCLES;
+		// The first press only wakes it up from standby.
+		if (idle_state == IDLE_ACTIVE) {
+			long_press_timeout = LONG_PRESS_TIMEOUT_CYCLES;
+		}
+
+		idle_activity = true;
 		break;
 	case MENU_SCREEN:
 		menu_action(ACTION_CLICK);
 		break;
 	case CALIBRATION_SCREEN:
-		if (cal_temp[0] == -1) {
-			cal_temp[0] = meas_temp;
+		cal_temp[cal_step] = meas_temp;
+		if (cal_step < (CAL_POINTS - 1)) {
+			cal_step++;
 		} else {
-			cal_temp[1] = meas_temp;
 			change_screen(CONFIRM_CAL_SCREEN);
 		}
 		break;
 	case CONFIRM_CAL_SCREEN:
 		// Set the new calibration variables and perform the interpolations.
-		settings.cal_var[0] = cal_temp[0];
-		settings.cal_var[1] = cal_temp[1];
+		for (uint8_t i = 0; i < CAL_POINTS; i++) {
+			settings.cal_var[i] = cal_temp[i];
+		}
 		perform_interpolations();
 
-		// Reset the calibration variables.
-		cal_temp[0] = -1;
-		cal_temp[1] = -1;
-
 		// Save everything and go back to the main screen.
 		save_next_time = true;
 		change_screen(MAIN_SCREEN);
 		break;
+	case AUTOTUNE_SCREEN:
+		// Save the new gains, or just get out of here if it didn't work out.
+		if (autotune_state == AUTOTUNE_DONE) {
+			save_next_time = true;
+			change_screen(MAIN_SCREEN);
+		} else {
+			change_screen(MENU_SCREEN);
+		}
+		break;
+	case DIAGNOSTICS_SCREEN:
 	case ABOUT_SCREEN:
 		change_screen(MENU_SCREEN);
 		break;
+	case SLEEP_SCREEN:
+		// Wake up, the rest is done by the main loop.
+		wake_requested = true;
+		__bic_SR_register_on_exit(LPM3_bits);
+		break;
 	}
 
 	P1IFG &= ~(SWITCH);
@@ -668,8 +1405,15 @@ __interrupt void Port_2(void) {
 	// Check P2IFG if RE_A is set?
 	// Maybe wait a couple of cycles to make sure the switch is steady?
 
+	// Wake up, the rest is done by the main loop.
+	if (current_screen == SLEEP_SCREEN) {
+		wake_requested = true;
+		__bic_SR_register_on_exit(LPM3_bits);
+	}
+
 	if ((last_RE_A == 0) && (P2IN & RE_A)) {
 		delay_us(10);
+		idle_activity = true;
 
 		if (P2IN & RE_B) {
 			// CCW
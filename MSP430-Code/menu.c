@@ -10,7 +10,6 @@
 #include <msp430g2553.h>
 #include <stdint.h>
 #include <stdbool.h>
-#include <stdio.h>
 #include <string.h>
 
 #include "delay.h"
@@ -18,11 +17,12 @@
 #include "menu.h"
 #include "screens.h"
 #include "lcd.h"
+#include "format.h"
 
 uint8_t current_menu = MENU_MAIN;
 uint8_t current_menu_item = 0;
+uint8_t first_menu_item = 0;
 bool editing_menu_item = false;
-char str[15];
 
 /**
  * Builds the menu list.
@@ -31,10 +31,18 @@ char str[15];
  */
 void build_menu(const int8_t menu) {
 	uint8_t effect = NORMAL;
+	uint8_t last = first_menu_item + MENU_ROWS;
+
+	// Only show the items that fit on the screen.
+	if (last > menu_num_items[menu]) {
+		last = menu_num_items[menu];
+	}
+
+	for (uint8_t i = first_menu_item; i < last; i++) {
+		uint8_t row = i - first_menu_item + 1;
 
-	for (uint8_t i = 0; i < menu_num_items[menu]; i++) {
 		// Set the line position.
-		lcd_set_pos(0, i + 1);
+		lcd_set_pos(0, row);
 
 		// Check if the current item is selected.
 		if ((i == current_menu_item) && !editing_menu_item) {
@@ -59,19 +67,23 @@ void build_menu(const int8_t menu) {
 					effect = NORMAL;
 				}
 
-				snprintf(str, sizeof(str), "%d%s",
-						 conv_adc_temp(settings.temp_preset[i]),
-						 settings.temp_unit_symbol);
-
-				lcd_set_pos(9 * (FONT_WIDTH + 1), i + 1);
-				lcd_print(str, effect);
+				lcd_set_pos(9 * (FONT_WIDTH + 1), row);
+				print_int(conv_adc_temp(settings.temp_preset[i]), 3, effect);
+				lcd_print(settings.temp_unit_symbol, effect);
 			}
 			break;
 		case MENU_CALIBRATION:
-			lcd_print(calibration_items[i], effect);
+			if (i == 0) {
+				lcd_print(calibration_items[0], effect);
+			} else if (i > CAL_POINTS) {
+				lcd_print(calibration_items[i - CAL_POINTS], effect);
+			} else {
+				lcd_print("Point ", effect);
+				print_int(i, 0, effect);
+			}
 
 			// Print the calibration values.
-			if ((i == 1) || (i == 2)) {
+			if ((i >= 1) && (i <= CAL_POINTS)) {
 				// Check if the current item is selected.
 				if ((editing_menu_item) && (i == current_menu_item)) {
 					effect = UNDERLINED;
@@ -79,14 +91,51 @@ void build_menu(const int8_t menu) {
 					effect = NORMAL;
 				}
 
-				snprintf(str, sizeof(str), "%d", settings.cal_var[i - 1]);
-				lcd_set_pos(11 * (FONT_WIDTH + 1), i + 1);
-				lcd_print(str, effect);
+				lcd_set_pos(11 * (FONT_WIDTH + 1), row);
+				print_int(settings.cal_var[i - 1], 3, effect);
 			}
 			break;
 		case MENU_UNITS:
 			lcd_print(units_items[i], effect);
 			break;
+		case MENU_POWER:
+			lcd_print(power_items[i], effect);
+
+			// Print the power values.
+			if (i < 5) {
+				// Check if the current item is selected.
+				if ((editing_menu_item) && (i == current_menu_item)) {
+					effect = UNDERLINED;
+				} else {
+					effect = NORMAL;
+				}
+
+				lcd_set_pos(10 * (FONT_WIDTH + 1), row);
+				switch (i) {
+				case 0:
+					print_int(settings.max_watts, 3, effect);
+					lcd_putc('W', effect);
+					break;
+				case 1:
+					print_int(settings.boost_time, 3, effect);
+					lcd_putc('s', effect);
+					break;
+				case 2:
+					print_int(settings.standby_time, 3, effect);
+					lcd_putc('m', effect);
+					break;
+				case 3:
+					lcd_set_pos(9 * (FONT_WIDTH + 1), row);
+					print_int(conv_adc_temp(settings.standby_temp), 3, effect);
+					lcd_print(settings.temp_unit_symbol, effect);
+					break;
+				case 4:
+					print_int(settings.sleep_time, 3, effect);
+					lcd_putc('m', effect);
+					break;
+				}
+			}
+			break;
 		}
 	}
 }
@@ -112,6 +161,45 @@ void edit_current_menu_item(const int counter) {
 			settings.cal_var[current_menu_item - 1]--;
 		}
 		break;
+	case MENU_POWER:
+		switch (current_menu_item) {
+		case 0:
+			if ((counter > 0) && (settings.max_watts < MAX_WATTS_LIMIT)) {
+				settings.max_watts++;
+			} else if ((counter < 0) && (settings.max_watts > MIN_WATTS_LIMIT)) {
+				settings.max_watts--;
+			}
+			break;
+		case 1:
+			if ((counter > 0) && (settings.boost_time < MAX_BOOST_TIME)) {
+				settings.boost_time++;
+			} else if ((counter < 0) && (settings.boost_time > 0)) {
+				settings.boost_time--;
+			}
+			break;
+		case 2:
+			if ((counter > 0) && (settings.standby_time < MAX_IDLE_TIME)) {
+				settings.standby_time++;
+			} else if ((counter < 0) && (settings.standby_time > 0)) {
+				settings.standby_time--;
+			}
+			break;
+		case 3:
+			if ((counter > 0) && (settings.standby_temp < MAX_SET_TEMP)) {
+				settings.standby_temp++;
+			} else if ((counter < 0) && (settings.standby_temp > MIN_SET_TEMP)) {
+				settings.standby_temp--;
+			}
+			break;
+		case 4:
+			if ((counter > 0) && (settings.sleep_time < MAX_IDLE_TIME)) {
+				settings.sleep_time++;
+			} else if ((counter < 0) && (settings.sleep_time > 0)) {
+				settings.sleep_time--;
+			}
+			break;
+		}
+		break;
 	}
 
 	// Redraw the menu items.
@@ -143,6 +231,13 @@ void load_menu_screen(const int8_t menu, const int counter) {
 		current_menu_item = 0;
 	}
 
+	// Scroll the list to keep the current item on the screen.
+	if (current_menu_item < first_menu_item) {
+		first_menu_item = current_menu_item;
+	} else if (current_menu_item >= (first_menu_item + MENU_ROWS)) {
+		first_menu_item = current_menu_item - MENU_ROWS + 1;
+	}
+
 	// Display the menu items.
 	build_menu(current_menu);
 }
@@ -152,7 +247,7 @@ void load_menu_screen(const int8_t menu, const int counter) {
  *
  * @param type Type of the action (click or long-press).
  */
-void menu_action(const uint8_t type) {
+void menu_action(const uint8_t /* type */) {
 	switch (current_menu) {
 	case MENU_MAIN:
 		switch (current_menu_item) {
@@ -165,14 +260,22 @@ void menu_action(const uint8_t type) {
 			load_menu_screen(MENU_CALIBRATION, 0);
 			break;
 		case 2:
+			// Power
+			load_menu_screen(MENU_POWER, 0);
+			break;
+		case 3:
 			// Units
 			load_menu_screen(MENU_UNITS, 0);
 			break;
-		case 3:
+		case 4:
+			// Diagnostics
+			change_screen(DIAGNOSTICS_SCREEN);
+			break;
+		case 5:
 			// About
 			change_screen(ABOUT_SCREEN);
 			break;
-		case 4:
+		case 6:
 			// Save
 			save_next_time = true;
 			change_screen(MAIN_SCREEN);
@@ -203,19 +306,23 @@ void menu_action(const uint8_t type) {
 		case 0:
 			change_screen(CALIBRATION_SCREEN);
 			break;
-		case 1:
-		case 2:
+		case (CAL_POINTS + 1):
+			change_screen(AUTOTUNE_SCREEN);
+			break;
+		case (CAL_POINTS + 2):
+			load_menu_screen(MENU_MAIN, 0);
+			break;
+		default:
+			// Calibration points, which take effect once they're done.
 			if (editing_menu_item) {
 				editing_menu_item = false;
+				perform_interpolations();
 			} else {
 				editing_menu_item = true;
 			}
 
 			build_menu(current_menu);
 			break;
-		case 3:
-			load_menu_screen(MENU_MAIN, 0);
-			break;
 		}
 		break;
 	case MENU_UNITS:
@@ -231,5 +338,25 @@ void menu_action(const uint8_t type) {
 			break;
 		}
 		break;
+	case MENU_POWER:
+		switch (current_menu_item) {
+		case 0:
+		case 1:
+		case 2:
+		case 3:
+		case 4:
+			if (editing_menu_item) {
+				editing_menu_item = false;
+			} else {
+				editing_menu_item = true;
+			}
+
+			build_menu(current_menu);
+			break;
+		case 5:
+			load_menu_screen(MENU_MAIN, 0);
+			break;
+		}
+		break;
 	}
 }
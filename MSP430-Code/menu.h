@@ -11,12 +11,17 @@
 #define MENU_H_
 
 #include <stdint.h>
+#include "settings.h"
 
 #define MENU_CURRENT    -1
 #define MENU_MAIN        0
 #define MENU_TEMPPRESETS 1
 #define MENU_CALIBRATION 2
 #define MENU_UNITS       3
+#define MENU_POWER       4
+
+// Number of menu items that fit on the screen below the title.
+#define MENU_ROWS 5
 
 #define ACTION_CLICK     0
 #define ACTION_LONGPRESS 1
@@ -30,21 +35,24 @@ void menu_action(const uint8_t type);
 void edit_current_menu_item(const int counter);
 
 // Number of items in each menu.
-static const uint8_t menu_num_items[] = { 5, 5, 4, 4 };
+static const uint8_t menu_num_items[] = { 7, 5, CAL_POINTS + 3, 4, 6 };
 
 // Menu titles.
 static const char menu_titles[][15] = {
 	"   Settings   ",
 	" Temp Presets ",
 	"  Calibration ",
-	"     Units    "
+	"     Units    ",
+	"     Power    "
 };
 
 // Main menu items.
 static const char main_items[][15] = {  // 14 characters + \0
 	"Temp. Presets",
 	"Calibration",
+	"Power",
 	"Units",
+	"Diagnostics",
 	"About",
 	"Save"
 };
@@ -58,11 +66,11 @@ static const char tempset_items[][15] = {
 	"Back"
 };
 
-// Calibration menu items.
+// Calibration menu items, with a "Point n" for each of the CAL_POINTS in
+// between the first one and the rest.
 static const char calibration_items[][15] = {
 	"Cal. Wizard",
-	"Var. 1",
-	"Var. 2",
+	"PID Autotune",
 	"Back"
 };
 
@@ -74,4 +82,14 @@ static const char units_items[][15] = {
 	"Back"
 };
 
+// Power menu items.
+static const char power_items[][15] = {
+	"Max Power",
+	"Boost",
+	"Standby",
+	"Stby Tmp",
+	"Sleep",
+	"Back"
+};
+
 #endif /* MENU_H_ */
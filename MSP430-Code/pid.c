@@ -0,0 +1,220 @@
+/**
+ *    Filename: pid.c
+ * Description: Fixed-point PID controller for the heater.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#include "pid.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "settings.h"
+
+// Integral term. (PWM counts in Q16)
+long pid_integral = 0;
+
+// Filtered measurement for the derivative term. (ADC counts in Q8)
+long pid_filtered = 0;
+
+// Slope of the filtered measurement. (ADC counts per period in Q8, times
+// 2^PID_LOAD_FILTER)
+long pid_slope = 0;
+
+// Power added to make up for a load. (PWM counts in Q8)
+long pid_load = 0;
+
+// Duty cycle per unit of power at the current supply voltage. (Q8)
+unsigned long pid_supply_scale = 256;
+
+// Fraction of a PWM count the last output had. (Q8)
+unsigned int pid_fraction = 0;
+
+// Sigma-delta error of the duty cycle. (Q8)
+unsigned int pid_dither = 0;
+
+/**
+ * Resets the controller state, should be done every time the heater was off.
+ *
+ * @param measured Current reading of the sensor in fine counts.
+ */
+void pid_reset(const unsigned int measured) {
+	pid_integral = 0;
+	pid_filtered = (long)measured << (8 - SENSE_FRAC_BITS);
+	pid_slope = 0;
+	pid_load = 0;
+	pid_fraction = 0;
+}
+
+/**
+ * Runs the controller for a new sample with the output and the power ceiling
+ * being the same thing.
+ *
+ * @param setpoint Target temperature in fine counts.
+ * @param measured Measured temperature in fine counts.
+ * @param max Maximum output (the largest duty we can actually deliver).
+ * @return New PWM duty cycle, between 0 and max.
+ */
+unsigned int pid_update(const unsigned int setpoint, const unsigned int measured,
+						const unsigned int max) {
+	return pid_update(setpoint, measured, max, max);
+}
+
+/**
+ * Runs the controller for a new sample. The error is in fine counts, so the
+ * proportional and integral terms get the fraction of an ADC count too.
+ *
+ * The integral and the load feed-forward are held under the power ceiling,
+ * which may be above this period's maximum output (when it has to make room
+ * for a reading), so that a short cut in the output doesn't throw away the
+ * integral and nothing winds up past what the heater can ever be given.
+ *
+ * @param setpoint Target temperature in fine counts.
+ * @param measured Measured temperature in fine counts.
+ * @param max Maximum output this period.
+ * @param ceiling Most power the heater may get, in the same units.
+ * @return New PWM duty cycle, between 0 and max.
+ */
+unsigned int pid_update(const unsigned int setpoint, const unsigned int measured,
+						const unsigned int max, const unsigned int ceiling) {
+	int error = (int)setpoint - (int)measured;
+	long limit = (long)ceiling << PID_KI_SHIFT;
+	long integral;
+	long output;
+
+	// Derivative on the filtered measurement, so that setpoint changes don't
+	// kick the output and single count steps don't make it jump around.
+	long last = pid_filtered;
+	pid_filtered += (((long)measured << (8 - SENSE_FRAC_BITS)) - pid_filtered) >> PID_D_FILTER;
+
+	// Proportional and derivative terms. (PWM counts in Q8)
+	output = ((long)settings.pid_kp * error) >> SENSE_FRAC_BITS;
+	output -= ((long)settings.pid_kd * (pid_filtered - last)) >> PID_KD_SHIFT;
+
+	// Load feed-forward: the iron slumping below the setpoint means something
+	// is pulling heat out of the tip, so put the power back right away instead
+	// of waiting for the integral to wind up, and hold it while it recovers.
+	pid_slope += (pid_filtered - last) - (pid_slope >> PID_LOAD_FILTER);
+	if (error <= 0) {
+		pid_load = 0;
+	} else {
+		// Scaled to counts/s before the filter is shifted out, since a slump
+		// under load is only a couple of counts per second, which is less
+		// than a Q8 step per period.
+		long slump = -(pid_slope * CONTROL_RATE_HZ) >> PID_LOAD_FILTER;  // Q8 counts/s
+		long boost;
+
+		if (slump > ((long)PID_LOAD_MAX_RATE << 8)) {
+			slump = (long)PID_LOAD_MAX_RATE << 8;
+		}
+
+		boost = (long)PID_LOAD_GAIN * (slump - ((long)PID_LOAD_MIN_RATE << (8 - SENSE_FRAC_BITS)));
+
+		if (boost > pid_load) {
+			pid_load = boost;
+		} else {
+			pid_load -= pid_load >> PID_LOAD_DECAY;
+		}
+
+		if (pid_load > ((long)ceiling << PID_KP_SHIFT)) {
+			pid_load = (long)ceiling << PID_KP_SHIFT;
+		}
+	}
+	output += pid_load;
+
+	// Integral term, clamped to the power ceiling.
+	integral = pid_integral + (((long)settings.pid_ki * error) >> SENSE_FRAC_BITS);
+	if (integral > limit) {
+		integral = limit;
+	} else if (integral < 0) {
+		integral = 0;
+	}
+
+	output += integral >> (PID_KI_SHIFT - PID_KP_SHIFT);
+
+	// Anti-windup: only let the integral grow while the output isn't already
+	// over the ceiling in the same direction.
+	if (!((output > ((long)ceiling << PID_KP_SHIFT)) && (error > 0)) &&
+			!((output < 0) && (error < 0))) {
+		pid_integral = integral;
+	}
+
+	// Clamp the output to what we can deliver, keeping the fraction around
+	// for the dithering.
+	if (output <= 0) {
+		pid_fraction = 0;
+		return 0;
+	} else if (output >= ((long)max << PID_KP_SHIFT)) {
+		pid_fraction = 0;
+		return max;
+	}
+
+	pid_fraction = (unsigned int)(output & 0xFF);  // Output in Q8.
+	return (unsigned int)(output >> PID_KP_SHIFT);
+}
+
+/**
+ * Updates the supply voltage used to convert power into duty cycle. Since the
+ * heater power goes with the square of the voltage, the duty is scaled by
+ * (nominal / vin)^2 to deliver the same power on any supply.
+ *
+ * @param vin Input voltage in ADC counts.
+ * @param nominal PID_VIN_NOMINAL in ADC counts.
+ */
+void pid_set_supply(const unsigned int vin, const unsigned int nominal) {
+	unsigned long v = vin;
+
+	// Don't go crazy with a dead (or unplugged) supply, the heater will be at
+	// full blast well before this anyway.
+	if (v <= (nominal >> 2)) {
+		v = (nominal >> 2) + 1;
+	}
+
+	pid_supply_scale = (((unsigned long)nominal * nominal) << 8) / (v * v);
+}
+
+/**
+ * Gets the most power that can be delivered at the current supply voltage.
+ *
+ * @param max_duty Largest duty cycle that can be sent to the heater.
+ * @return Maximum power, in duty cycle at the nominal voltage.
+ */
+unsigned int pid_max_power(const unsigned int max_duty) {
+	return (unsigned int)(((unsigned long)max_duty << 8) / pid_supply_scale);
+}
+
+/**
+ * Converts a power into the duty cycle that delivers it on the current supply.
+ *
+ * @param power Power, in duty cycle at the nominal voltage.
+ * @return Duty cycle.
+ */
+unsigned int pid_power_to_duty(const unsigned int power) {
+	return (unsigned int)(((unsigned long)power * pid_supply_scale) >> 8);
+}
+
+/**
+ * Converts a power into a duty cycle like pid_power_to_duty(), but carries
+ * what's left of a PWM count (including the fraction of the last controller
+ * output) over to the next control periods. Over a few periods the heater
+ * gets the exact power instead of being stuck on whole PWM counts, which
+ * matters at the higher PWM frequencies where a count is a lot of power.
+ *
+ * @param power Power, in duty cycle at the nominal voltage.
+ * @return Duty cycle.
+ */
+unsigned int pid_dither_duty(const unsigned int power) {
+	unsigned long duty = ((((unsigned long)power << 8) + pid_fraction) * pid_supply_scale) >> 8;
+
+	// First order sigma-delta. (duty in Q8)
+	pid_dither += (unsigned int)(duty & 0xFF);
+	duty >>= 8;
+	if (pid_dither >= 256) {
+		pid_dither -= 256;
+		duty++;
+	}
+
+	return (unsigned int)duty;
+}
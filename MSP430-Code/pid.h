@@ -0,0 +1,62 @@
+/**
+ *    Filename: pid.h
+ * Description: Fixed-point PID controller for the heater.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#ifndef PID_H_
+#define PID_H_
+
+#include <stdint.h>
+#include "timer.h"
+#include "heater.h"
+
+// Fixed-point formats of the gains. (all of them per control period)
+#define PID_KP_SHIFT 8   // Kp in Q8.8, PWM counts per ADC count.
+#define PID_KI_SHIFT 16  // Ki in Q0.16, PWM counts per ADC count per period.
+#define PID_KD_SHIFT 0   // Kd in Q16.0, PWM counts per ADC count/period.
+
+// Measurement filter for the derivative. (time constant of 2^n periods)
+#define PID_D_FILTER 4
+
+// Load feed-forward, power put back as soon as the iron starts slumping below
+// the setpoint, like when it touches a ground plane.
+#ifndef PID_LOAD_GAIN
+#define PID_LOAD_GAIN     ((400UL * PWM_PERIOD) / 500)  // PWM counts per ADC count/s of slump.
+#endif
+#define PID_LOAD_MIN_RATE 6   // Slump that counts as a load. (fine counts/s)
+#define PID_LOAD_FILTER   8   // Slope filter. (time constant of 2^n periods)
+#define PID_LOAD_DECAY    8   // Decay once the slump stops. (2^n periods)
+#define PID_LOAD_MAX_RATE 64  // Slump past which the boost can't get any bigger. (ADC counts/s)
+
+// The filtered slope times CONTROL_RATE_HZ has to fit in a long.
+#if (PID_LOAD_FILTER > 8)
+#error "The load slope filter can't be longer than 2^8 periods."
+#endif
+
+// Supply voltage the controller output is referenced to. The output is the
+// duty cycle that would give the wanted power at this voltage.
+#define PID_VIN_NOMINAL 24
+
+// Default gains. (for a Hakko 907 controlled every 2ms with a 500 count PWM,
+// scaled to the actual period and PWM)
+#define PID_DEFAULT_KP ((10240UL * PWM_PERIOD) / 500)                         // 40.0
+#define PID_DEFAULT_KI ((300UL * CONTROL_PERIOD_MS * PWM_PERIOD) / (2 * 500))  // 0.0046
+#define PID_DEFAULT_KD ((2000UL * 2 * PWM_PERIOD) / (CONTROL_PERIOD_MS * 500))
+
+void pid_reset(const unsigned int measured);
+unsigned int pid_update(const unsigned int setpoint, const unsigned int measured,
+						const unsigned int max);
+unsigned int pid_update(const unsigned int setpoint, const unsigned int measured,
+						const unsigned int max, const unsigned int ceiling);
+
+// Supply voltage feed-forward.
+void pid_set_supply(const unsigned int vin, const unsigned int nominal);
+unsigned int pid_max_power(const unsigned int max_duty);
+unsigned int pid_power_to_duty(const unsigned int power);
+unsigned int pid_dither_duty(const unsigned int power);
+
+#endif /* PID_H_ */
@@ -10,7 +10,6 @@
 #include <msp430g2553.h>
 #include <stdint.h>
 #include <stdbool.h>
-#include <stdio.h>
 #include <string.h>
 
 #include "screens.h"
@@ -18,7 +17,7 @@
 #include "version.h"
 
 uint8_t current_screen = SPLASH_SCREEN;
-bool screen_setup = true;
+volatile bool screen_setup = true;
 
 /**
  * Changes into a new screen.
@@ -27,11 +26,11 @@ bool screen_setup = true;
  * @return New screen ID.
  */
 uint8_t change_screen(const uint8_t screen) {
-	TA0CCR1 = 0;  // Turn off the heater.
-	lcd_clear();  // Clear the screen for a new one to be drawn.
+	screen_setup = true;  // Stops the control loop.
+	TA0CCR1 = 0;          // Turn off the heater.
+	lcd_clear();          // Clear the screen for a new one to be drawn.
 
 	current_screen = screen;
-	screen_setup = true;
 
 	return current_screen;
 }
@@ -40,8 +39,6 @@ uint8_t change_screen(const uint8_t screen) {
  * Displays the splash screen of the device.
  */
 void splash_screen() {
-	char str[15];
-
 	lcd_print("  Porta");
 	lcd_set_pos(0, 1);
 	lcd_print("     Station");
@@ -51,9 +48,8 @@ void splash_screen() {
 	lcd_set_pos(0, 4);
 	lcd_print("   Workshop");
 
-	snprintf(str, sizeof(str), "          v%s", VERSION);
 	lcd_set_pos(0, 5);
-	lcd_print(str);
+	lcd_print("          v" VERSION);
 }
 
 /**
@@ -78,19 +74,15 @@ void recovery_screen() {
 }
 
 void about_screen() {
-	char str[15];
-
-	snprintf(str, sizeof(str), "HW Rev.: %c", HW_REVISION);
 	lcd_set_pos(0, 0);
-	lcd_print(str);
+	lcd_print("HW Rev.: ");
+	lcd_putc(HW_REVISION);
 
-	snprintf(str, sizeof(str), "SW Ver.: %s", VERSION);
 	lcd_set_pos(0, 1);
-	lcd_print(str);
+	lcd_print("SW Ver.: " VERSION);
 
-	snprintf(str, sizeof(str), "Build: %s", BUILD_NUM);
 	lcd_set_pos(0, 2);
-	lcd_print(str);
+	lcd_print("Build: " BUILD_NUM);
 
 	lcd_set_pos(0, 3);
 	lcd_print(" PortaStation ");
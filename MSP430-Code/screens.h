@@ -18,9 +18,12 @@
 #define CONFIRM_CAL_SCREEN 4
 #define RECOVERY_SCREEN    5
 #define ABOUT_SCREEN       6
+#define AUTOTUNE_SCREEN    7
+#define SLEEP_SCREEN       8
+#define DIAGNOSTICS_SCREEN 9
 
 extern uint8_t current_screen;
-extern bool screen_setup;
+extern volatile bool screen_setup;
 
 uint8_t change_screen(const uint8_t screen);
 
@@ -0,0 +1,270 @@
+/**
+ *    Filename: sense.c
+ * Description: Picks how many samples go into each sensor reading, from how
+ *              noisy the sensor is and how far the iron is from the setpoint,
+ *              and filters the readings before anyone uses them.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#include "sense.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "estimator.h"
+
+// Even the longest readings have to keep the estimator happy.
+#if ((SENSE_MAX_READING_MS * 2) > EST_MAX_AGE_MS)
+#error "The longest reading has to be at most half of EST_MAX_AGE_MS."
+#endif
+
+// Length of a control period. (SMCLK counts)
+#define CONTROL_CYCLES ((long)CONTROL_PERIOD_MS * (SMCLK_HZ / 1000))
+
+// While in a hurry there has to be a new reading every control period.
+#if ((SENSE_SEQ_CYCLES << SENSE_MIN_ORDER) > (CONTROL_PERIOD_MS * (SMCLK_HZ / 1000)))
+#error "The PWM is too slow to get a reading every control period."
+#endif
+
+// The filters keep their extra bits in 16 bits.
+#if ((SENSE_FINE(1024L) << SENSE_FILTER_FRAC) > 65536L)
+#error "SENSE_FILTER_FRAC is too big for the fine counts."
+#endif
+
+// Standard deviation of a single sample. (fine counts in Q4)
+unsigned int sense_sigma = SENSE_START_NOISE;
+
+// Budget for the next readings. (2^n sequences)
+volatile uint8_t sense_next_order = SENSE_MIN_ORDER;
+
+// Control periods the heater has to leave room for one of these readings.
+uint8_t sense_periods = 2;
+
+// Last readings, for the median. (fine counts)
+unsigned int sense_history[3] = { 0, 0, 0 };
+uint8_t sense_history_pos = 0;
+
+// Filtered readings. (fine counts with SENSE_FILTER_FRAC extra bits)
+unsigned int sense_control = 0;
+unsigned int sense_display = 0;
+
+/**
+ * Sets the budget for the next readings.
+ *
+ * @param order Readings will have 2^order sequences.
+ */
+void sense_set_order(const uint8_t order) {
+	long cycles;
+
+	// Readings aren't lined up with the control periods, so they need one
+	// more than they take.
+	sense_periods = 1;
+	for (cycles = (long)SENSE_SEQ_CYCLES << order; cycles > 0; cycles -= CONTROL_CYCLES) {
+		sense_periods++;
+	}
+
+	sense_next_order = order;
+}
+
+/**
+ * Forgets the noise that was measured and goes back to the shortest readings.
+ */
+void sense_reset() {
+	sense_sigma = SENSE_START_NOISE;
+	sense_set_order(SENSE_MIN_ORDER);
+}
+
+/**
+ * Takes the noise of a reading that was used into account.
+ *
+ * @param jitter Sum of the jumps between samples next to each other in the
+ *               same DTC block. (ADC counts)
+ * @param order The reading had 2^order sequences.
+ */
+void sense_add_reading(const unsigned int jitter, const uint8_t order) {
+	// Jumps in a block, on average. (ADC counts in Q4)
+	unsigned long block = ((unsigned long)jitter << 4) >> (order - ADC_BLOCK_ORDER);
+	unsigned int sigma = (unsigned int)((block * SENSE_SIGMA_GAIN) >> 8);
+
+	sense_sigma += ((int)sigma - (int)sense_sigma) >> SENSE_NOISE_FILTER;
+	sample_count += 1 << order;
+}
+
+/**
+ * Picks the budget for the next readings. Far from the setpoint a fresh
+ * reading is worth more than a clean one, so they're as short as they get,
+ * otherwise they're just long enough to average away the noise.
+ *
+ * @param setpoint Target temperature in fine counts.
+ * @param measured Current temperature in fine counts.
+ */
+void sense_budget(const unsigned int setpoint, const unsigned int measured) {
+	unsigned int error = (setpoint > measured) ? (setpoint - measured) : (measured - setpoint);
+	unsigned long variance = (unsigned long)sense_sigma * sense_sigma;  // Q8
+	uint8_t order = SENSE_MIN_ORDER;
+
+	// Averaging 2^n samples divides the variance by 2^n.
+	if (error <= SENSE_FINE(SENSE_HURRY_ERROR)) {
+		while ((order < SENSE_MAX_ORDER) &&
+			   (variance > (((unsigned long)SENSE_TARGET_NOISE * SENSE_TARGET_NOISE) << order))) {
+			order++;
+		}
+	}
+
+	if (order != sense_next_order) {
+		sense_set_order(order);
+	}
+}
+
+/**
+ * Gets the budget for the next readings.
+ *
+ * @return Sequences in a reading. (2^n)
+ */
+uint8_t sense_order() {
+	return sense_next_order;
+}
+
+/**
+ * Gets for how many control periods in a row the heater has to stay under
+ * SENSE_MAX_DUTY to get a clean reading.
+ *
+ * @return Control periods.
+ */
+uint8_t sense_run_periods() {
+	return sense_periods;
+}
+
+/**
+ * Gets the noise of a single sample.
+ *
+ * @return Standard deviation. (fine counts in Q4)
+ */
+unsigned int sense_noise() {
+	return sense_sigma;
+}
+
+/**
+ * Gets the variance of the readings with the current budget.
+ *
+ * @return Variance. (fine counts squared in Q8)
+ */
+unsigned int sense_variance() {
+	unsigned long variance = ((unsigned long)sense_sigma * sense_sigma) >> sense_next_order;
+
+	if (variance > 0xFFFF) {
+		return 0xFFFF;
+	}
+
+	return (unsigned int)variance;
+}
+
+/**
+ * Starts the filters over from a reading, as if it had been there forever.
+ *
+ * @param reading Sensor reading in fine counts.
+ */
+void sense_filter_reset(const unsigned int reading) {
+	for (uint8_t i = 0; i < 3; i++) {
+		sense_history[i] = reading;
+	}
+
+	sense_control = reading << SENSE_FILTER_FRAC;
+	sense_display = reading << SENSE_FILTER_FRAC;
+}
+
+/**
+ * Median of three values.
+ *
+ * @param a First value.
+ * @param b Second value.
+ * @param c Third value.
+ * @return The one in the middle.
+ */
+unsigned int median3(unsigned int a, unsigned int b, const unsigned int c) {
+	unsigned int tmp;
+
+	// Sort the first two and put the third one in between them.
+	if (a > b) {
+		tmp = a;
+		a = b;
+		b = tmp;
+	}
+
+	if (c < a) {
+		return a;
+	} else if (c > b) {
+		return b;
+	}
+
+	return c;
+}
+
+/**
+ * Moves a single pole low-pass filter towards a reading. Everything is
+ * unsigned since the filtered value takes the whole 16 bits.
+ *
+ * @param state Filtered value. (fine counts with SENSE_FILTER_FRAC extra bits)
+ * @param reading Sensor reading in fine counts.
+ * @param order Time constant of 2^order readings.
+ * @return New filtered value.
+ */
+unsigned int low_pass(const unsigned int state, const unsigned int reading,
+					  const uint8_t order) {
+	unsigned int target = reading << SENSE_FILTER_FRAC;
+
+	if (target > state) {
+		return state + ((target - state) >> order);
+	}
+
+	return state - ((state - target) >> order);
+}
+
+/**
+ * Runs a new reading through the filters.
+ *
+ * @param reading Sensor reading in fine counts.
+ */
+void sense_filter(const unsigned int reading) {
+	unsigned int median = reading;
+
+#if SENSE_MEDIAN
+	sense_history[sense_history_pos] = reading;
+	if (++sense_history_pos >= 3) {
+		sense_history_pos = 0;
+	}
+
+	median = median3(sense_history[0], sense_history[1], sense_history[2]);
+#endif
+
+	// Pulling the iron out or plugging it back in has to show up right away,
+	// not after the filters crawl all the way there.
+	if ((median >= SENSE_OPEN) != (sense_display_temp() >= SENSE_OPEN)) {
+		sense_control = median << SENSE_FILTER_FRAC;
+		sense_display = median << SENSE_FILTER_FRAC;
+		return;
+	}
+
+	sense_control = low_pass(sense_control, median, SENSE_CONTROL_FILTER);
+	sense_display = low_pass(sense_display, median, SENSE_DISPLAY_FILTER);
+}
+
+/**
+ * Gets the temperature the controller should work with.
+ *
+ * @return Filtered reading in fine counts.
+ */
+unsigned int sense_control_temp() {
+	return (sense_control + (1 << (SENSE_FILTER_FRAC - 1))) >> SENSE_FILTER_FRAC;
+}
+
+/**
+ * Gets the temperature that should be shown.
+ *
+ * @return Filtered reading in fine counts.
+ */
+unsigned int sense_display_temp() {
+	return (sense_display + (1 << (SENSE_FILTER_FRAC - 1))) >> SENSE_FILTER_FRAC;
+}
@@ -0,0 +1,82 @@
+/**
+ *    Filename: sense.h
+ * Description: Picks how many samples go into each sensor reading, from how
+ *              noisy the sensor is and how far the iron is from the setpoint,
+ *              and filters the readings before anyone uses them.
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#ifndef SENSE_H_
+#define SENSE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "timer.h"
+#include "heater.h"
+
+// Timing of a reading.
+#define SENSE_SEQ_CYCLES     (ADC_CONVS * PWM_PERIOD)  // SMCLK counts per sequence.
+#define SENSE_MAX_READING_MS 8                         // Half of EST_MAX_AGE_MS.
+#define SENSE_MAX_SEQS       ((SENSE_MAX_READING_MS * (SMCLK_HZ / 1000)) / SENSE_SEQ_CYCLES)
+
+// Sample budget, a reading is made of 2^n sequences. The longest one has to
+// fit in SENSE_MAX_READING_MS and its sums in 16 bits.
+#define SENSE_MIN_ORDER 2  // 4 sequences.
+#if (SENSE_MAX_SEQS >= 64)
+#define SENSE_MAX_ORDER 6  // 64 sequences.
+#elif (SENSE_MAX_SEQS >= 32)
+#define SENSE_MAX_ORDER 5  // 32 sequences.
+#else
+#define SENSE_MAX_ORDER 4  // 16 sequences.
+#endif
+
+// Every extra bit of the oversampling takes four times the samples, so the
+// shortest readings only have one of them for real.
+#if (SENSE_MIN_ORDER < SENSE_FRAC_BITS) || (SENSE_MIN_ORDER < ADC_BLOCK_ORDER)
+#error "The shortest reading has to be at least a DTC block and SENSE_FRAC_BITS long."
+#endif
+
+// Budget policy.
+#define SENSE_START_NOISE  32  // Noise before it's been measured. (fine counts in Q4, half an ADC count)
+#define SENSE_HURRY_ERROR  4  // ADC counts from the setpoint to want quick readings. (about 2.5C)
+#define SENSE_TARGET_NOISE 8  // Standard deviation a reading should have. (fine counts in Q4)
+#define SENSE_NOISE_FILTER 4  // Noise estimate filter. (time constant of 2^n readings)
+
+// Standard deviation of a sample from the sum of the jumps between the ones
+// next to each other in a DTC block. (fine counts per ADC count, times the
+// sqrt(pi) / 2 that relates the two for gaussian noise, in Q8)
+#define SENSE_SIGMA_GAIN ((4UL * 227) / (ADC_BLOCK_SEQS - 1))
+
+// Filters between the readings and whoever uses them. A median of the last
+// three readings throws away the spikes from the heater switching, then the
+// controller and the screen each get their own single pole low-pass.
+#ifndef SENSE_MEDIAN
+#define SENSE_MEDIAN 1          // 0 turns it off.
+#endif
+#ifndef SENSE_CONTROL_FILTER
+#define SENSE_CONTROL_FILTER 1  // Time constant of 2^n readings, 0 turns it off.
+#endif
+#ifndef SENSE_DISPLAY_FILTER
+#define SENSE_DISPLAY_FILTER 4  // Time constant of 2^n readings, 0 turns it off.
+#endif
+#define SENSE_FILTER_FRAC 4  // Extra bits the filters keep.
+
+// Anything at the top of the scale is an open sensor. (fine counts)
+#define SENSE_OPEN SENSE_FINE(1023)
+
+void sense_reset();
+void sense_add_reading(const unsigned int jitter, const uint8_t order);
+void sense_budget(const unsigned int setpoint, const unsigned int measured);
+uint8_t sense_order();
+uint8_t sense_run_periods();
+unsigned int sense_noise();
+unsigned int sense_variance();
+void sense_filter_reset(const unsigned int reading);
+void sense_filter(const unsigned int reading);
+unsigned int sense_control_temp();
+unsigned int sense_display_temp();
+
+#endif /* SENSE_H_ */
@@ -10,38 +10,94 @@
 #include <msp430g2553.h>
 #include <stdint.h>
 #include <stdbool.h>
-#include <stdio.h>
 #include <string.h>
 
 #include "settings.h"
 #include "delay.h"
 #include "eeprom.h"
+#include "pid.h"
+#include "heater.h"
 
 // Settings memory positions.
-#define MCAL_VAR1H      0
-#define MCAL_VAR1L      1
-#define MCAL_VAR2H      2
-#define MCAL_VAR2L      3
+#define MCAL_PT1H       0
+#define MCAL_PT1L       1
+#define MCAL_PT3H       2
+#define MCAL_PT3L       3
 #define MTEMP_UNIT      4
 #define MLAST_SET_TEMPH 5
 #define MLAST_SET_TEMPL 6
 #define MSENSEWHENOFF   7
 #define MTEMP_PRESETH   8
 #define MTEMP_PRESETL   9
+#define MPID_KPH        16
+#define MPID_KPL        17
+#define MPID_KIH        18
+#define MPID_KIL        19
+#define MPID_KDH        20
+#define MPID_KDL        21
+#define MMAX_WATTS      22
+#define MBOOST_TIME     23
+#define MSTANDBY_TIME   24
+#define MSLEEP_TIME     25
+#define MSTANDBY_TEMPH  26
+#define MSTANDBY_TEMPL  27
+#define MCAL_PT0H       28
+#define MCAL_PT0L       29
+#define MCAL_PT2H       30
+#define MCAL_PT2L       31
+#define MCAL_PT4H       32
+#define MCAL_PT4L       33
+
+// Value of a word that was never written.
+#define EEPROM_BLANK 0xFFFF
+
+// Where each calibration point lives, the two from the old calibration stayed
+// where they were. (high byte, the low one is right after it)
+static const uint8_t cal_var_addr[CAL_POINTS] = {
+	MCAL_PT0H, MCAL_PT1H, MCAL_PT2H, MCAL_PT3H, MCAL_PT4H
+};
+
+// Factory calibration.
+static const int cal_default_temps[CAL_POINTS] = CAL_DEFAULT_TEMPS;
 
 // Global variables.
 SettingsData settings;
 bool save_next_time = false;
-float adc_temp_params[2] = { 0.0, 0.0 };
-float temp_adc_params[2] = { 0.0, 0.0 };
+
+// Span of a calibration segment in fine counts.
+#define CONV_SPAN SENSE_FINE((long)CAL_POINT_SPAN)
+
+// Lines between each pair of calibration points, kept in integers so the
+// conversions don't need floating point. They work in fine counts so that the
+// oversampled readings are converted without losing their fraction.
+// (Celsius * CONV_SPAN = conv_base[i] + fine counts * conv_slope[i])
+long conv_base[CAL_POINTS - 1];
+int conv_slope[CAL_POINTS - 1];
+
+// Private functions.
+uint8_t adc_segment(const unsigned int value);
+uint8_t temp_segment(const long celsius, const int scale);
 
 /**
  * Loads the settings from the EEPROM into the settings variable.
  */
 void load_settings() {
 	// Calibration variables.
-	settings.cal_var[0] = (eeprom_read(MCAL_VAR1H) << 8) + eeprom_read(MCAL_VAR1L);
-	settings.cal_var[1] = (eeprom_read(MCAL_VAR2H) << 8) + eeprom_read(MCAL_VAR2L);
+	for (uint8_t i = 0; i < CAL_POINTS; i++) {
+		settings.cal_var[i] = (eeprom_read(cal_var_addr[i]) << 8) +
+							  eeprom_read(cal_var_addr[i] + 1);
+	}
+
+	// Units calibrated on an older firmware only have the two middle points,
+	// so the rest follow the factory curve with the same correction.
+	if (settings.cal_var[0] == (int)EEPROM_BLANK) {
+		int low = settings.cal_var[1] - cal_default_temps[1];
+		int high = settings.cal_var[3] - cal_default_temps[3];
+
+		settings.cal_var[0] = cal_default_temps[0] + low - ((high - low) / 2);
+		settings.cal_var[2] = cal_default_temps[2] + ((low + high) / 2);
+		settings.cal_var[4] = cal_default_temps[4] + high + ((high - low) / 2);
+	}
 
 	// Perform the necessary interpolations.
 	perform_interpolations();
@@ -78,6 +134,36 @@ void load_settings() {
 		settings.temp_preset[i] = (eeprom_read(MTEMP_PRESETH + (i * 2)) << 8) +
 								  eeprom_read(MTEMP_PRESETL + (i * 2));
 	}
+
+	// PID gains.
+	settings.pid_kp = (eeprom_read(MPID_KPH) << 8) + eeprom_read(MPID_KPL);
+	settings.pid_ki = (eeprom_read(MPID_KIH) << 8) + eeprom_read(MPID_KIL);
+	settings.pid_kd = (eeprom_read(MPID_KDH) << 8) + eeprom_read(MPID_KDL);
+
+	// Units that were upgraded from an older firmware never had them saved.
+	if (settings.pid_kp == EEPROM_BLANK) {
+		settings.pid_kp = PID_DEFAULT_KP;
+		settings.pid_ki = PID_DEFAULT_KI;
+		settings.pid_kd = PID_DEFAULT_KD;
+	}
+
+	// Power ceiling and boost.
+	settings.max_watts = eeprom_read(MMAX_WATTS);
+	settings.boost_time = eeprom_read(MBOOST_TIME);
+	if (settings.max_watts == (EEPROM_BLANK & 0xFF)) {
+		settings.max_watts = DEFAULT_MAX_WATTS;
+		settings.boost_time = DEFAULT_BOOST_TIME;
+	}
+
+	// Idle timeouts and standby temperature.
+	settings.standby_time = eeprom_read(MSTANDBY_TIME);
+	settings.sleep_time = eeprom_read(MSLEEP_TIME);
+	settings.standby_temp = (eeprom_read(MSTANDBY_TEMPH) << 8) + eeprom_read(MSTANDBY_TEMPL);
+	if (settings.standby_time == (EEPROM_BLANK & 0xFF)) {
+		settings.standby_time = DEFAULT_STANDBY_TIME;
+		settings.sleep_time = DEFAULT_SLEEP_TIME;
+		settings.standby_temp = conv_temp_adc(230, CELSIUS);
+	}
 }
 
 /**
@@ -85,8 +171,9 @@ void load_settings() {
  */
 void load_default_settings() {
 	// Calibration variables.
-	settings.cal_var[0] = 270;
-	settings.cal_var[1] = 415;
+	for (uint8_t i = 0; i < CAL_POINTS; i++) {
+		settings.cal_var[i] = cal_default_temps[i];
+	}
 
 	// Perform the necessary interpolations.
 	perform_interpolations();
@@ -107,6 +194,20 @@ void load_default_settings() {
 	settings.last_set_temp = conv_temp_adc(250);
 	settings.sense_when_off = 1;
 
+	// PID gains.
+	settings.pid_kp = PID_DEFAULT_KP;
+	settings.pid_ki = PID_DEFAULT_KI;
+	settings.pid_kd = PID_DEFAULT_KD;
+
+	// Power ceiling and boost.
+	settings.max_watts = DEFAULT_MAX_WATTS;
+	settings.boost_time = DEFAULT_BOOST_TIME;
+
+	// Idle timeouts and standby temperature.
+	settings.standby_time = DEFAULT_STANDBY_TIME;
+	settings.sleep_time = DEFAULT_SLEEP_TIME;
+	settings.standby_temp = conv_temp_adc(230, CELSIUS);
+
 	// Constants.
 	settings.vref = 3.253;
 	settings.rheater = 12.36;
@@ -119,10 +220,11 @@ void load_default_settings() {
  * shit, don't ask me why.
  */
 void commit_settings() {
-	eeprom_write(MCAL_VAR1H, settings.cal_var[0] >> 8);
-	eeprom_write(MCAL_VAR1L, settings.cal_var[0] & 0xFF);
-	eeprom_write(MCAL_VAR2H, settings.cal_var[1] >> 8);
-	eeprom_write(MCAL_VAR2L, settings.cal_var[1] & 0xFF);
+	for (uint8_t i = 0; i < CAL_POINTS; i++) {
+		eeprom_write(cal_var_addr[i], settings.cal_var[i] >> 8);
+		eeprom_write(cal_var_addr[i] + 1, settings.cal_var[i] & 0xFF);
+	}
+
 	eeprom_write(MTEMP_UNIT, settings.temp_unit);
 	eeprom_write(MLAST_SET_TEMPH, settings.last_set_temp >> 8);
 	eeprom_write(MLAST_SET_TEMPL, settings.last_set_temp & 0xFF);
@@ -147,44 +249,77 @@ void commit_settings() {
 		eeprom_write(MTEMP_PRESETH + (i * 2), settings.temp_preset[i] >> 8);
 		eeprom_write(MTEMP_PRESETL + (i * 2), settings.temp_preset[i] & 0xFF);
 	}
+
+	eeprom_write(MPID_KPH, settings.pid_kp >> 8);
+	eeprom_write(MPID_KPL, settings.pid_kp & 0xFF);
+	eeprom_write(MPID_KIH, settings.pid_ki >> 8);
+	eeprom_write(MPID_KIL, settings.pid_ki & 0xFF);
+	eeprom_write(MPID_KDH, settings.pid_kd >> 8);
+	eeprom_write(MPID_KDL, settings.pid_kd & 0xFF);
+
+	eeprom_write(MMAX_WATTS, settings.max_watts);
+	eeprom_write(MBOOST_TIME, settings.boost_time);
+
+	eeprom_write(MSTANDBY_TIME, settings.standby_time);
+	eeprom_write(MSLEEP_TIME, settings.sleep_time);
+	eeprom_write(MSTANDBY_TEMPH, settings.standby_temp >> 8);
+	eeprom_write(MSTANDBY_TEMPL, settings.standby_temp & 0xFF);
 }
 
 /**
- * Interpolates the function for getting a temperature from the ADC value.
- *
- * @param temp1 First temperature measured.
- * @param temp2 Second temperature measured.
- * @param adc1 First ADC reference value.
- * @param adc2 Second ADC reference value.
+ * Interpolates the lines used to convert between ADC values and temperatures
+ * using the calibration points in the settings.
  */
-void interpolate_adc_temp(const int temp1, const int temp2,
-						  const unsigned int adc1, const unsigned int adc2) {
-	adc_temp_params[0] = (float)(temp2 - temp1) / (float)(adc2 - adc1);
-	adc_temp_params[1] = temp1 - (adc_temp_params[0] * (float)adc1);
+void perform_interpolations() {
+	for (uint8_t i = 0; i < (CAL_POINTS - 1); i++) {
+		int slope = settings.cal_var[i + 1] - settings.cal_var[i];
+
+		// A botched calibration shouldn't divide by zero.
+		if (slope == 0) {
+			slope = 1;
+		}
+
+		conv_slope[i] = slope;
+		conv_base[i] = ((long)settings.cal_var[i] * CONV_SPAN) -
+					   (SENSE_FINE((long)CAL_POINT_ADC(i)) * slope);
+	}
 }
 
 /**
- * Interpolates the function for getting a ADC value from a temperature.
+ * Finds the calibration segment a reading is in. Readings outside of the
+ * calibrated range use the segment at that end.
  *
- * @param temp1 First temperature measured.
- * @param temp2 Second temperature measured.
- * @param adc1 First ADC reference value.
- * @param adc2 Second ADC reference value.
+ * @param value Reading in fine counts.
+ * @return Segment index.
  */
-void interpolate_temp_adc(const int temp1, const int temp2,
-						  const unsigned int adc1, const unsigned int adc2) {
-	temp_adc_params[0] = (float)(adc2 - adc1) / (float)(temp2 - temp1);
-	temp_adc_params[1] = adc1 - (temp_adc_params[0] * (float)temp1);
+uint8_t adc_segment(const unsigned int value) {
+	uint8_t i = 0;
+
+	while ((i < (CAL_POINTS - 2)) &&
+		   (value >= (unsigned int)SENSE_FINE(CAL_POINT_ADC(i + 1)))) {
+		i++;
+	}
+
+	return i;
 }
 
 /**
- * Performs all the interpolations using the variables in the settings.
+ * Finds the calibration segment a temperature is in. Temperatures outside of
+ * the calibrated range use the segment at that end.
+ *
+ * @param celsius Temperature in Celsius * scale.
+ * @param scale Scale of the temperature.
+ * @return Segment index.
  */
-void perform_interpolations() {
-	interpolate_adc_temp(settings.cal_var[0], settings.cal_var[1],//cal_temp[0], cal_temp[1],
-						 CAL_LOW_TEMP_ADC, CAL_HIGH_TEMP_ADC);
-	interpolate_temp_adc(settings.cal_var[0], settings.cal_var[1],//cal_temp[0], cal_temp[1],
-						 CAL_LOW_TEMP_ADC, CAL_HIGH_TEMP_ADC);
+uint8_t temp_segment(const long celsius, const int scale) {
+	uint8_t i = 0;
+
+	while ((i < (CAL_POINTS - 2)) &&
+		   (celsius >= ((long)settings.cal_var[i + 1] * scale))) {
+		i++;
+	}
+
+	return i;
 }
 
 /**
@@ -194,29 +329,54 @@ void perform_interpolations() {
  * @return Temperature.
  */
 int conv_adc_temp(const unsigned int value) {
-	float temp = conv_adc_temp(value, settings.temp_unit);
-	return (int)temp;
+	return conv_adc_temp(value, settings.temp_unit);
 }
 
 /**
  * Converts a ADC value to a temperature.
  *
  * @param value ADC value.
+ * @param unit Temperature unit ID.
  * @return Temperature.
  */
 int conv_adc_temp(const unsigned int value, const uint8_t unit) {
-	float temp = (adc_temp_params[0] * value) + adc_temp_params[1]; //(0.4525 * value) - 5.4299;  // YAY! MAGIC NUMBERS!!
+	return conv_fine_adc_temp(SENSE_FINE(value), unit);
+}
+
+/**
+ * Converts an oversampled sensor reading to a temperature using the unit in
+ * the settings.
+ *
+ * @param value Reading in fine counts.
+ * @return Temperature.
+ */
+int conv_fine_adc_temp(const unsigned int value) {
+	return conv_fine_adc_temp(value, settings.temp_unit);
+}
+
+/**
+ * Converts an oversampled sensor reading to a temperature. Everything is kept
+ * as an exact fraction until the very end, so it's a single division for any
+ * unit.
+ *
+ * @param value Reading in fine counts.
+ * @param unit Temperature unit ID.
+ * @return Temperature.
+ */
+int conv_fine_adc_temp(const unsigned int value, const uint8_t unit) {
+	uint8_t i = adc_segment(value);
+	long temp = conv_base[i] + ((long)value * conv_slope[i]);  // Celsius * span
 
 	switch (unit) {
 	case FAHRENHEIT:
-		temp = (1.8 * temp) + 32;
-		break;
+		// F = 1.8C + 32
+		return (int)(((9 * temp) + (160L * CONV_SPAN)) / (5L * CONV_SPAN));
 	case KELVIN:
-		temp += 273.15;
-		break;
+		// K = C + 273.15
+		return (int)(((20 * temp) + (5463L * CONV_SPAN)) / (20L * CONV_SPAN));
 	}
 
-	return (int)temp;
+	return (int)(temp / CONV_SPAN);
 }
 
 /**
@@ -238,19 +398,32 @@ unsigned int conv_temp_adc(const int temp) {
  * @return ADC value.
  */
 unsigned int conv_temp_adc(const int temp, const uint8_t unit) {
-	float val = (float)temp;
+	long celsius = temp;  // Celsius * scale
+	int scale = 1;
+	uint8_t i;
+	long val;
 
 	switch (unit) {
 	case FAHRENHEIT:
-		val = (val - 32) / 1.8;
+		// C = (F - 32) / 1.8
+		celsius = 5L * (temp - 32);
+		scale = 9;
 		break;
 	case KELVIN:
-		val -= 273.15;
+		// C = K - 273.15
+		celsius = (20L * temp) - 5463;
+		scale = 20;
 		break;
 	}
 
-	val = (temp_adc_params[0] * val) + temp_adc_params[1]; //(2.21 * val) + 12;
-	return (unsigned int)val;
+	i = temp_segment(celsius, scale);
+	val = ((celsius * CONV_SPAN) - (conv_base[i] * scale)) /
+		  ((long)conv_slope[i] * scale);  // Fine counts.
+	if (val < 0) {
+		return 0;
+	}
+
+	return (unsigned int)SENSE_COARSE(val);
 }
 
 /**
@@ -293,6 +466,10 @@ char get_temp_unit(const uint8_t unit) {
 	case KELVIN:
 		c = 'K';
 		break;
+	default:
+		// The conversions treat anything else as Celsius.
+		c = 'C';
+		break;
 	}
 
 	return c;
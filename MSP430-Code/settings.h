@@ -20,17 +20,37 @@
 #define FAHRENHEIT 1
 #define KELVIN     2
 
-// Calibration ADC points.
-#define CAL_LOW_TEMP_ADC  565
-#define CAL_HIGH_TEMP_ADC 785
+// Calibration ADC points, equally spaced so every segment of the curve has the
+// same span. The old two point calibration used the second and fourth ones.
+#define CAL_POINTS        5  // Up to 8, two per row when they're confirmed.
+#define CAL_FIRST_ADC     455
+#define CAL_POINT_SPAN    110
+#define CAL_POINT_ADC(i)  (CAL_FIRST_ADC + ((i) * CAL_POINT_SPAN))
+#define CAL_LOW_TEMP_ADC  CAL_POINT_ADC(1)
+#define CAL_HIGH_TEMP_ADC CAL_POINT_ADC(3)
+
+// Factory calibration, fitted to the Hakko sensor by Emulator/calfit.cpp.
+#define CAL_DEFAULT_TEMPS { 204, 270, 340, 415, 495 }
 
 // Temperature limits. (using ADC units)
 #define MIN_SET_TEMP 490
 #define MAX_SET_TEMP 1000
 
+// Power limits.
+#define MIN_WATTS_LIMIT    10
+#define MAX_WATTS_LIMIT    150
+#define MAX_BOOST_TIME     60   // Seconds.
+#define DEFAULT_MAX_WATTS  40
+#define DEFAULT_BOOST_TIME 10
+
+// Idle timeouts. (in minutes)
+#define MAX_IDLE_TIME        60
+#define DEFAULT_STANDBY_TIME 5
+#define DEFAULT_SLEEP_TIME   10
+
 typedef struct {
 	int temp_preset[NUM_TEMP_PRESETS];
-	int cal_var[2];
+	int cal_var[CAL_POINTS];
 
 	uint8_t temp_unit;
 	char temp_unit_symbol[3];
@@ -38,6 +58,17 @@ typedef struct {
 	bool sense_when_off;
 	unsigned int last_set_temp;
 
+	unsigned int pid_kp;
+	unsigned int pid_ki;
+	unsigned int pid_kd;
+
+	uint8_t max_watts;
+	uint8_t boost_time;
+
+	uint8_t standby_time;
+	uint8_t sleep_time;
+	unsigned int standby_temp;
+
 	float vref;
 	float rheater;
 	float vin_ratio;
@@ -48,15 +79,13 @@ extern SettingsData settings;
 extern bool save_next_time;
 
 // Interpolation stuff.
-void interpolate_adc_temp(const int temp1, const int temp2,
-						  const unsigned int adc1, const unsigned int adc2);
-void interpolate_temp_adc(const int temp1, const int temp2,
-						  const unsigned int adc1, const unsigned int adc2);
 void perform_interpolations();
 
 // ADC and temperature conversions.
 int conv_adc_temp(const unsigned int value, const uint8_t unit);
 int conv_adc_temp(const unsigned int value);
+int conv_fine_adc_temp(const unsigned int value, const uint8_t unit);
+int conv_fine_adc_temp(const unsigned int value);
 unsigned int conv_temp_adc(const int temp, const uint8_t unit);
 unsigned int conv_temp_adc(const int temp);
 
@@ -0,0 +1,105 @@
+/**
+ *    Filename: timer.c
+ * Description: System tick and a tiny scheduler (Timer1_A).
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#include "timer.h"
+#include <msp430g2553.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Global variables.
+volatile unsigned int ticks = 0;
+volatile unsigned int control_count = 0;
+volatile unsigned int render_count = 0;
+volatile unsigned int sample_count = 0;
+unsigned int control_rate = 0;
+unsigned int render_rate = 0;
+unsigned int sample_rate = 0;
+unsigned int rate_ticks = 0;
+uint8_t control_ticks = 0;
+volatile bool tick_waiting = false;
+
+/**
+ * Sets up Timer1_A in continuous mode with CCR0 generating the system tick.
+ */
+void timer_setup() {
+	TA1CCR0  = TICK_COUNTS;                    // First tick.
+	TA1CCTL0 = CCIE;                           // CCR0 interrupt enabled.
+	TA1CTL   = TASSEL_2 + ID_3 + MC_2 + TACLR; // SMCLK/8, continuous mode.
+}
+
+/**
+ * Checks if a period has elapsed since the last time, and restarts it if so.
+ *
+ * @param last Tick of the last time the period elapsed.
+ * @param period Period in milliseconds.
+ * @return TRUE if the period elapsed.
+ */
+bool timer_elapsed(unsigned int *last, const unsigned int period) {
+	unsigned int now = ticks;
+
+	if ((unsigned int)(now - *last) >= period) {
+		*last = now;
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * Puts the CPU to sleep until the next tick.
+ */
+void timer_sleep() {
+	__disable_interrupt();
+	tick_waiting = true;
+	__bis_SR_register(LPM0_bits + GIE);  // Sleep until the tick wakes us.
+}
+
+/**
+ * Waits for some milliseconds with the CPU asleep between the ticks.
+ *
+ * @param ms Number of milliseconds to wait.
+ */
+void timer_delay(const unsigned int ms) {
+	unsigned int start = ticks;
+
+	while ((unsigned int)(ticks - start) < ms) {
+		timer_sleep();
+	}
+}
+
+// Timer1_A CCR0 interrupt service routine.
+#pragma vector = TIMER1_A0_VECTOR
+__interrupt void Timer1_A0_ISR(void) {
+	TA1CCR0 += TICK_COUNTS;  // Schedule the next tick.
+	ticks++;
+
+	// Run the heater control loop at a fixed rate, no matter what the
+	// foreground is busy with.
+	if (++control_ticks >= CONTROL_PERIOD_MS) {
+		control_ticks = 0;
+		control_tick();
+	}
+
+	// Latch the achieved rates every second.
+	if (++rate_ticks >= 1000) {
+		control_rate = control_count;
+		render_rate = render_count;
+		sample_rate = sample_count;
+		control_count = 0;
+		render_count = 0;
+		sample_count = 0;
+		rate_ticks = 0;
+	}
+
+	// Wake up whoever is waiting for us.
+	if (tick_waiting) {
+		tick_waiting = false;
+		__bic_SR_register_on_exit(CPUOFF);
+	}
+}
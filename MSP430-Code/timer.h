@@ -0,0 +1,53 @@
+/**
+ *    Filename: timer.h
+ * Description: System tick and a tiny scheduler (Timer1_A).
+ *  Created on: Oct 17, 2026
+ *      Author: Nathan Campos <nathan@innoveworkshop.com>
+ *
+ * Copyright (C) 2017 Innove Workshop - All Rights Reserved
+ */
+
+#ifndef TIMER_H_
+#define TIMER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Tick configuration. (SMCLK / 8 = 2MHz)
+#define TICK_COUNTS 2000  // 1ms.
+
+// Control loop period, anything from 2ms (500Hz) to 10ms (100Hz).
+#ifndef CONTROL_PERIOD_MS
+#define CONTROL_PERIOD_MS 2
+#endif
+#define CONTROL_RATE_HZ (1000 / CONTROL_PERIOD_MS)
+
+// Scheduler periods.
+#define RENDER_PERIOD_MS 100  // 10Hz.
+#define RENDER_RATE_HZ   (1000 / RENDER_PERIOD_MS)
+
+// A new temperature reading only comes every 2ms. (with the default PWM)
+#if (CONTROL_PERIOD_MS < 2)
+#error "The control loop can't run faster than the ADC readings."
+#endif
+
+// Tick counter, in milliseconds.
+extern volatile unsigned int ticks;
+
+// Achieved rates, updated every second.
+extern volatile unsigned int control_count;
+extern volatile unsigned int render_count;
+extern volatile unsigned int sample_count;
+extern unsigned int control_rate;
+extern unsigned int render_rate;
+extern unsigned int sample_rate;
+
+void timer_setup();
+bool timer_elapsed(unsigned int *last, const unsigned int period);
+void timer_sleep();
+void timer_delay(const unsigned int ms);
+
+// Heater control loop, called from the tick interrupt every CONTROL_PERIOD_MS.
+void control_tick();
+
+#endif /* TIMER_H_ */